@@ -0,0 +1,173 @@
+/** @file
+ * @brief Bounded Channel
+ *
+ * This file contains the blocking queue of limited size that connects the ingestion with the filters
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref BoundedChannel_legal_note_sec
+ *
+ * @section BoundedChannel_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section BoundedChannel_intro_sec Introduction
+ *
+ * A producer pushes items and a consumer pops them concurrently. When the channel holds its queue size limit the
+ * producer waits, like the producers of the ComposerPool do, so a fast reader can not grow the memory of a slow filter.
+ * Closing the channel wakes everybody: the producer stops pushing and the consumer drains what is left.
+ *
+ * @section BoundedChannel_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section BoundedChannel_install_sec Use
+ *
+ * @subsection BoundedChannel_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef BOUNDEDCHANNEL_HPP
+#define BOUNDEDCHANNEL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace Qustodio
+{
+
+/*! \class BoundedChannel BoundedChannel.hpp "BoundedChannel.hpp"
+ *  \brief Blocking queue with backpressure between a producer and a consumer.
+ */
+  template < class T >
+  class BoundedChannel
+  {
+    public:
+    /**
+     * @brief Constructor
+     * @param queueSizeLimit [in] the items held before #push waits, at least one
+     */
+    explicit BoundedChannel ( std::size_t queueSizeLimit = defaultQueueSizeLimit )
+            : queueSizeLimit( ( std::max )( queueSizeLimit, std::size_t( 1 ) ) )
+    { }
+
+    BoundedChannel ( const BoundedChannel & ) = delete;
+    BoundedChannel &operator= ( const BoundedChannel & ) = delete;
+
+    /**
+     * @brief Queues #item, waiting while the channel is full
+     * @param item [in] the item to move into the channel
+     * @return false when the channel was closed and #item was not queued
+     */
+    bool push ( T &&item );
+
+    /**
+     * @brief Takes the oldest item, waiting while the channel is empty and open
+     * @param item [out] the item taken
+     * @return false when the channel is closed and there is nothing left
+     */
+    bool pop ( T &item );
+
+    /**
+     * @brief Closes the channel, the queued items can still be popped
+     */
+    void close ();
+
+    /**
+     * @brief True once #close has been called
+     */
+    bool closed () const;
+
+    /**
+     * @brief Items waiting in the channel
+     */
+    std::size_t size () const;
+
+    /**
+     * @brief Changes the items held before #push waits, at least one
+     */
+    void setQueueSizeLimit ( std::size_t limit );
+
+    static const std::size_t defaultQueueSizeLimit = 8; //< Items held by default before #push waits
+
+    private:
+    mutable std::mutex channelMutex;        //< Protects every member below
+    std::condition_variable producers;      //< Signaled when an item leaves or the channel closes
+    std::condition_variable consumers;      //< Signaled when an item arrives or the channel closes
+    std::deque< T > items;                  //< The queued items
+    std::size_t queueSizeLimit;             //< Items held before #push waits
+    bool isClosed = false;                  //< Set by #close
+  };
+
+  template < class T >
+  const std::size_t BoundedChannel< T >::defaultQueueSizeLimit;
+
+  template < class T >
+  bool BoundedChannel< T >::push ( T &&item )
+  {
+    std::unique_lock< std::mutex > lock( this->channelMutex );
+    this->producers.wait( lock, [ this ] { return this->items.size() < this->queueSizeLimit || this->isClosed; } );
+
+    if ( this->isClosed )
+      return false;
+
+    this->items.push_back( std::move( item ) );
+    this->consumers.notify_one();
+    return true;
+  }
+
+  template < class T >
+  bool BoundedChannel< T >::pop ( T &item )
+  {
+    std::unique_lock< std::mutex > lock( this->channelMutex );
+    this->consumers.wait( lock, [ this ] { return !this->items.empty() || this->isClosed; } );
+
+    if ( this->items.empty() )
+      return false;
+
+    item = std::move( this->items.front() );
+    this->items.pop_front();
+    this->producers.notify_one();
+    return true;
+  }
+
+  template < class T >
+  void BoundedChannel< T >::close ()
+  {
+    std::lock_guard< std::mutex > lock( this->channelMutex );
+    this->isClosed = true;
+    this->producers.notify_all();
+    this->consumers.notify_all();
+  }
+
+  template < class T >
+  bool BoundedChannel< T >::closed () const
+  {
+    std::lock_guard< std::mutex > lock( this->channelMutex );
+    return this->isClosed;
+  }
+
+  template < class T >
+  std::size_t BoundedChannel< T >::size () const
+  {
+    std::lock_guard< std::mutex > lock( this->channelMutex );
+    return this->items.size();
+  }
+
+  template < class T >
+  void BoundedChannel< T >::setQueueSizeLimit ( std::size_t limit )
+  {
+    std::lock_guard< std::mutex > lock( this->channelMutex );
+    const std::size_t oldLimit = this->queueSizeLimit;
+    this->queueSizeLimit = ( std::max )( limit, std::size_t( 1 ) );
+    if ( oldLimit < this->queueSizeLimit )
+      this->producers.notify_all();
+  }
+
+} // namespace Qustodio
+
+#endif // BOUNDEDCHANNEL_HPP
@@ -1,6 +1,6 @@
 #include "BrowsingEvent.hpp"
 
-std::string Qustodio::BrowsingEvent::Device ()
+const std::string &Qustodio::BrowsingEvent::Device () const
 {
   return this->m_Device;
 }
@@ -10,7 +10,12 @@ void Qustodio::BrowsingEvent::Device ( const std::string &device )
   this->m_Device= device;
 }
 
-std::string Qustodio::BrowsingEvent::Url ()
+void Qustodio::BrowsingEvent::Device ( const char *device, std::size_t length )
+{
+  this->m_Device.assign( device, length );
+}
+
+const std::string &Qustodio::BrowsingEvent::Url () const
 {
   return this->m_Url;
 }
@@ -20,7 +25,12 @@ void Qustodio::BrowsingEvent::Url ( const std::string &url )
   this->m_Url= url;
 }
 
-std::string Qustodio::BrowsingEvent::Timestamp ()
+void Qustodio::BrowsingEvent::Url ( const char *url, std::size_t length )
+{
+  this->m_Url.assign( url, length );
+}
+
+const std::string &Qustodio::BrowsingEvent::Timestamp () const
 {
   return this->m_Timestamp;
 }
@@ -29,3 +39,8 @@ void Qustodio::BrowsingEvent::Timestamp ( const std::string &timestamp )
 {
   this->m_Timestamp= timestamp;
 }
+
+void Qustodio::BrowsingEvent::Timestamp ( const char *timestamp, std::size_t length )
+{
+  this->m_Timestamp.assign( timestamp, length );
+}
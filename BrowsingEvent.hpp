@@ -31,6 +31,7 @@
 #ifndef BROWSINGEVENT_H
 #define BROWSINGEVENT_H
 
+#include <cstddef>
 #include <string>
 
 namespace Qustodio
@@ -44,12 +45,15 @@ namespace Qustodio
 class BrowsingEvent
 {
 public:
-  std::string Device ();                           //< Getter to Device MAC-Address
+  const std::string &Device () const;              //< Getter to Device MAC-Address
   void Device ( const std::string &device );       //< Setter to Device MAC-Address
-  std::string Url ();                              //< Getter to the visited website
+  void Device ( const char *device, std::size_t length ); //< Setter to Device MAC-Address from a raw buffer
+  const std::string &Url () const;                 //< Getter to the visited website
   void Url ( const std::string &url );             //< Setter to the visited website
-  std::string Timestamp ();                        //< Getter to time in seconds since UNIX epoch event took place
+  void Url ( const char *url, std::size_t length ); //< Setter to the visited website from a raw buffer
+  const std::string &Timestamp () const;           //< Getter to time in seconds since UNIX epoch event took place
   void Timestamp ( const std::string &timestamp ); //< Setter to time in seconds since UNIX epoch event took place
+  void Timestamp ( const char *timestamp, std::size_t length ); //< Setter to the event time from a raw buffer
 
 protected:
 private:
@@ -0,0 +1,63 @@
+/** @file
+ * @brief Browsing Event View
+ *
+ * This file contains the Browsing Event View class, a Browsing Event that references its fields instead of owning them
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref BrowsingEventView_legal_note_sec
+ *
+ * @section BrowsingEventView_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section BrowsingEventView_intro_sec Introduction
+ *
+ * This is the model of a Browsing Element produced by the zero-copy ingestion: the url, device and timestamp are
+ * views into the memory mapped log, so the event is three pointers and three lengths and copying it is free.
+ *
+ * @section BrowsingEventView_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section BrowsingEventView_install_sec Use
+ *
+ * @subsection BrowsingEventView_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef BROWSINGEVENTVIEW_HPP
+#define BROWSINGEVENTVIEW_HPP
+
+#include "StringRef.hpp"
+
+#include <cstddef>
+
+namespace Qustodio
+{
+
+/*! \class BrowsingEventView BrowsingEventView.hpp "BrowsingEventView.hpp"
+ *  \brief Browsing event model referencing an external buffer.
+ *
+ * The buffer the fields point into must outlive the event.
+ */
+  class BrowsingEventView
+  {
+    public:
+    StringRef Device () const { return m_Device; }       //< Getter to Device MAC-Address
+    StringRef Url () const { return m_Url; }             //< Getter to the visited website
+    StringRef Timestamp () const { return m_Timestamp; } //< Getter to time in seconds since UNIX epoch event took place
+
+    void Device ( const char *device, std::size_t length ) { m_Device = StringRef( device, length ); }  //< Setter to Device MAC-Address
+    void Url ( const char *url, std::size_t length ) { m_Url = StringRef( url, length ); }              //< Setter to the visited website
+    void Timestamp ( const char *timestamp, std::size_t length ) { m_Timestamp = StringRef( timestamp, length ); } //< Setter to the event time
+
+    private:
+    StringRef m_Device;    //< Device MAC-Address
+    StringRef m_Url;       //< the visited website
+    StringRef m_Timestamp; //< time in seconds since UNIX epoch event took place
+  };
+
+} // namespace Qustodio
+
+#endif // BROWSINGEVENTVIEW_HPP
@@ -0,0 +1,76 @@
+#include "BrowsingRecordParser.hpp"
+
+#include <cstring>
+
+namespace
+{
+  inline bool isBlank ( char character )
+  {
+    return ' ' == character || '\t' == character || '\r' == character;
+  }
+
+  inline bool keyEquals ( const char *first, std::size_t length, const char *key, std::size_t keyLength )
+  {
+    return length == keyLength && 0 == std::memcmp( first, key, keyLength );
+  }
+} // namespace
+
+Qustodio::BrowsingRecordTokenizer::Field
+Qustodio::BrowsingRecordTokenizer::tokenize ( const char *first, const char *last,
+                                             const char *&valueFirst, const char *&valueLast, bool &startsRecord )
+{
+  startsRecord = false;
+
+  while ( first != last && isBlank( * first ) )
+    ++first;
+  while ( last != first && isBlank( * ( last - 1 ) ) )
+    --last;
+
+  if ( first == last )
+  {
+    startsRecord = true;
+    return FieldNone;
+  }
+
+  if ( '-' == * first )
+  {
+    startsRecord = true;
+    ++first;
+    while ( first != last && isBlank( * first ) )
+      ++first;
+  }
+
+  const char *colon = static_cast< const char * >( std::memchr( first, ':', static_cast< std::size_t >( last - first ) ) );
+  if ( nullptr == colon )
+    return FieldNone;
+
+  const std::size_t keyLength = static_cast< std::size_t >( colon - first );
+  Field field = FieldNone;
+  switch ( keyLength )
+  {
+    case 3:
+      if ( keyEquals( first, keyLength, "url", 3 ) )
+        field = FieldUrl;
+      break;
+    case 6:
+      if ( keyEquals( first, keyLength, "device", 6 ) )
+        field = FieldDevice;
+      break;
+    case 9:
+      if ( keyEquals( first, keyLength, "timestamp", 9 ) )
+        field = FieldTimestamp;
+      break;
+    default:
+      break;
+  }
+
+  valueFirst = colon + 1;
+  while ( valueFirst != last && isBlank( * valueFirst ) )
+    ++valueFirst;
+  valueLast = last;
+
+  if ( valueFirst == valueLast )
+    return FieldNone;
+
+  return field;
+}
@@ -0,0 +1,272 @@
+/** @file
+ * @brief Browsing Record Parser
+ *
+ * This file contains the streaming tokenizer that assembles complete Browsing Events from the browsing log lines
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref BrowsingRecordParser_legal_note_sec
+ *
+ * @section BrowsingRecordParser_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section BrowsingRecordParser_intro_sec Introduction
+ *
+ * Every line of the browsing log holds one `key: value` pair, where key is one of `url`, `device` or `timestamp`.
+ * The parser scans each line once, dispatches on the key and groups consecutive fields into a single record. A record
+ * is closed when its three fields have been seen, when a field repeats, on an empty line, on a `-` list marker or at
+ * the end of the input.
+ *
+ * @section BrowsingRecordParser_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section BrowsingRecordParser_install_sec Use
+ *
+ * @subsection BrowsingRecordParser_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef BROWSINGRECORDPARSER_HPP
+#define BROWSINGRECORDPARSER_HPP
+
+#include "BrowsingEvent.hpp"
+#include "BrowsingEventView.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#if SHOW_INTERMEDIATE
+#include <iostream>
+#include <string>
+#endif
+
+namespace Qustodio
+{
+
+/*! \class BrowsingRecordTokenizer BrowsingRecordParser.hpp "BrowsingRecordParser.hpp"
+ *  \brief Splits a log line into its key and value.
+ */
+  class BrowsingRecordTokenizer
+  {
+    public:
+    /**
+     * @brief Fields recognised in a log line, usable as a bit mask
+     */
+    enum Field : unsigned
+    {
+      FieldNone      = 0u,
+      FieldUrl       = 1u,
+      FieldDevice    = 2u,
+      FieldTimestamp = 4u,
+      FieldAll       = FieldUrl | FieldDevice | FieldTimestamp
+    };
+
+    /**
+     * @brief Splits a single line into its key and value without allocating
+     * @param first [in] the first character of the line
+     * @param last [in] one past the last character of the line (without the line break)
+     * @param valueFirst [out] the first character of the value
+     * @param valueLast [out] one past the last character of the value
+     * @param startsRecord [out] true when the line is empty or starts with a `-` list marker
+     * @return the field of the line, #FieldNone when the key is unknown or the value is empty
+     */
+    static Field tokenize ( const char *first, const char *last,
+                            const char *&valueFirst, const char *&valueLast, bool &startsRecord );
+
+    /**
+     * @brief Tracks the fields of the record being assembled, as #BasicBrowsingRecordParser::feedLine does
+     * @param seenFields [in] the fields seen before the line
+     * @param field [in] the field of the line
+     * @param startsRecord [in] true when the line starts a new record
+     * @return the fields seen after the line, #FieldNone when no record is left open
+     */
+    static unsigned advance ( unsigned seenFields, Field field, bool startsRecord )
+    {
+      if ( startsRecord || ( seenFields & field ) )
+        seenFields = FieldNone;
+      if ( FieldNone == field )
+        return seenFields;
+      seenFields |= field;
+      return FieldAll == seenFields ? static_cast< unsigned >( FieldNone ) : seenFields;
+    }
+  };
+
+/*! \class BasicBrowsingRecordParser BrowsingRecordParser.hpp "BrowsingRecordParser.hpp"
+ *  \brief Single-pass tokenizer of the browsing log.
+ *
+ * Feed it line by line; whenever #feedLine or #finish return true, #takeEvent gives back the assembled record.
+ * The Event type needs the `Url`, `Device` and `Timestamp` setters taking a pointer and a length: #BrowsingEvent
+ * copies the values, #BrowsingEventView only references them, so the lines must outlive it.
+ */
+  template < class Event >
+  class BasicBrowsingRecordParser : public BrowsingRecordTokenizer
+  {
+    public:
+    /**
+     * @brief Feeds one line of the log
+     * @param first [in] the first character of the line
+     * @param last [in] one past the last character of the line (without the line break)
+     * @return true when a record has been completed and can be taken with #takeEvent
+     */
+    bool feedLine ( const char *first, const char *last );
+
+    /**
+     * @brief Feeds a buffer holding whole lines, calling #onEvent with every completed record
+     * @param first [in] the first character of the buffer
+     * @param last [in] one past the last character of the buffer
+     * @param onEvent [in] callable receiving an `Event &&`
+     */
+    template < class Callback >
+    void feedBuffer ( const char *first, const char *last, Callback &&onEvent );
+
+    /**
+     * @brief Flushes the pending record at the end of the input
+     * @return true when a record has been completed and can be taken with #takeEvent
+     */
+    bool finish ();
+
+    /**
+     * @brief Moves out the last completed record
+     */
+    Event takeEvent ();
+
+    /**
+     * @brief Continues a record whose first fields were fed to another parser
+     *
+     * The record is only followed to know where it ends: it is dropped when it closes, and #feedLine and #finish
+     * return false for it. Lets several parsers share a buffer cut at arbitrary lines.
+     * @param fields [in] the fields of the record already fed to the other parser
+     */
+    void resume ( unsigned fields );
+
+    bool pending () const { return FieldNone != seenFields; } //< True while a record is being assembled
+    bool resuming () const { return dropCurrent; }            //< True until the record given to #resume closes
+
+    private:
+    /**
+     * @brief Closes the record being assembled, if any
+     * @return true when there was something to close
+     */
+    bool closeRecord ();
+
+    Event current;                   //< The record being assembled
+    Event completed;                 //< The last completed record
+    unsigned seenFields = FieldNone; //< The fields already assigned to #current
+    bool dropCurrent = false;        //< #current started in another parser, see #resume
+  };
+
+  typedef BasicBrowsingRecordParser< Qustodio::BrowsingEvent > BrowsingRecordParser;         //< Owning parser
+  typedef BasicBrowsingRecordParser< Qustodio::BrowsingEventView > BrowsingEventViewParser;  //< Zero-copy parser
+
+  template < class Event >
+  bool BasicBrowsingRecordParser< Event >::feedLine ( const char *first, const char *last )
+  {
+    const char *valueFirst = nullptr;
+    const char *valueLast = nullptr;
+    bool startsRecord = false;
+    bool closed = false;
+
+    const Field field = tokenize( first, last, valueFirst, valueLast, startsRecord );
+
+    if ( startsRecord || ( this->seenFields & field ) )
+      closed = this->closeRecord();
+
+    if ( FieldNone == field )
+      return closed;
+
+    const std::size_t length = static_cast< std::size_t >( valueLast - valueFirst );
+    switch ( field )
+    {
+      case FieldUrl:
+#if SHOW_INTERMEDIATE
+        std::cout << "Insert Url: " << std::string( valueFirst, length ) << std::endl;
+#endif
+        this->current.Url( valueFirst, length );
+        break;
+      case FieldDevice:
+#if SHOW_INTERMEDIATE
+        std::cout << "Insert Device: " << std::string( valueFirst, length ) << std::endl;
+#endif
+        this->current.Device( valueFirst, length );
+        break;
+      case FieldTimestamp:
+#if SHOW_INTERMEDIATE
+        std::cout << "Insert Timestamp: " << std::string( valueFirst, length ) << std::endl;
+#endif
+        this->current.Timestamp( valueFirst, length );
+        break;
+      default:
+        break;
+    }
+    this->seenFields |= field;
+
+    if ( FieldAll == this->seenFields )
+      closed = this->closeRecord();
+
+    return closed;
+  }
+
+  template < class Event >
+  template < class Callback >
+  void BasicBrowsingRecordParser< Event >::feedBuffer ( const char *first, const char *last, Callback &&onEvent )
+  {
+    while ( first != last )
+    {
+      const char *lineEnd = static_cast< const char * >(
+              std::memchr( first, '\n', static_cast< std::size_t >( last - first ) ) );
+      if ( nullptr == lineEnd )
+        lineEnd = last;
+
+      if ( this->feedLine( first, lineEnd ) )
+        onEvent( this->takeEvent() );
+
+      first = lineEnd == last ? last : lineEnd + 1;
+    }
+  }
+
+  template < class Event >
+  bool BasicBrowsingRecordParser< Event >::finish ()
+  {
+    return this->closeRecord();
+  }
+
+  template < class Event >
+  Event BasicBrowsingRecordParser< Event >::takeEvent ()
+  {
+    return std::move( this->completed );
+  }
+
+  template < class Event >
+  void BasicBrowsingRecordParser< Event >::resume ( unsigned fields )
+  {
+    this->current = Event();
+    this->seenFields = fields & FieldAll;
+    this->dropCurrent = FieldNone != this->seenFields;
+  }
+
+  template < class Event >
+  bool BasicBrowsingRecordParser< Event >::closeRecord ()
+  {
+    if ( FieldNone == this->seenFields )
+      return false;
+
+    if ( this->dropCurrent )
+    {
+      this->current = Event();
+      this->seenFields = FieldNone;
+      this->dropCurrent = false;
+      return false;
+    }
+
+    this->completed = std::move( this->current );
+    this->current = Event();
+    this->seenFields = FieldNone;
+    return true;
+  }
+
+} // namespace Qustodio
+
+#endif // BROWSINGRECORDPARSER_HPP
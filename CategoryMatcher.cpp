@@ -0,0 +1,37 @@
+#include "CategoryMatcher.hpp"
+
+#include <stdexcept>
+
+const std::size_t Qustodio::CategoryMatcher::MaxCategories;
+
+namespace
+{
+  /**
+   * @brief The non empty keywords of every category, in the order the #KeywordMatcher numbers them
+   */
+  std::vector< std::string > allKeywords ( const std::vector< Qustodio::CategoryMatcher::Category > &categories )
+  {
+    std::vector< std::string > keywords;
+    for ( auto &&category: categories )
+      for ( auto &&keyword: category.keywords )
+        if ( !keyword.empty() )
+          keywords.push_back( keyword );
+    return keywords;
+  }
+} // namespace
+
+Qustodio::CategoryMatcher::CategoryMatcher ( const std::vector< Category > &categories, bool caseInsensitive )
+        : matcher( categories.size() > MaxCategories ? std::vector< std::string >()
+                                                     : allKeywords( categories ), caseInsensitive )
+{
+  if ( categories.size() > MaxCategories )
+    throw std::invalid_argument( "CategoryMatcher: more than 64 categories" );
+
+  for ( std::size_t index = 0; index < categories.size(); ++index )
+  {
+    this->names.push_back( categories[index].name );
+    for ( auto &&keyword: categories[index].keywords )
+      if ( !keyword.empty() )
+        this->keywordMasks.push_back( Mask( 1 ) << index );
+  }
+}
@@ -0,0 +1,100 @@
+/** @file
+ * @brief Category Matcher
+ *
+ * This file contains the rule set classifying every url in several named categories with a single scan
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref CategoryMatcher_legal_note_sec
+ *
+ * @section CategoryMatcher_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section CategoryMatcher_intro_sec Introduction
+ *
+ * Each category, such as adult, gambling or social, is a named list of keywords. Instead of one automaton per
+ * category, the keywords of all the categories are compiled together into a single #KeywordMatcher and every keyword
+ * remembers the bit of its category. Classifying a url scans it once and ORs the bits of the keywords found, so the
+ * cost is one table lookup per byte whatever the number of categories.
+ *
+ * @section CategoryMatcher_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section CategoryMatcher_install_sec Use
+ *
+ * @subsection CategoryMatcher_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef CATEGORYMATCHER_HPP
+#define CATEGORYMATCHER_HPP
+
+#include "KeywordMatcher.hpp"
+#include "StringRef.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class CategoryMatcher CategoryMatcher.hpp "CategoryMatcher.hpp"
+ *  \brief Classifies urls in up to #MaxCategories named keyword categories at once.
+ *
+ * Immutable once built, so a single instance can be shared by every worker of a #ComposerPool.
+ */
+  class CategoryMatcher
+  {
+    public:
+    typedef std::uint64_t Mask; //< Bit #c set when the url belongs to the category #c
+
+    static const std::size_t MaxCategories = 64; //< Bits of a #Mask
+
+    /**
+     * @brief A named list of keywords, the url belongs to the category when it contains any of them
+     */
+    struct Category
+    {
+      std::string name;                    //< The name of the category, such as `adult`
+      std::vector< std::string > keywords; //< The keywords of the category, empty keywords are ignored
+    };
+
+    /**
+     * @brief Compiles the keywords of every category into a single automaton
+     * @param categories [in] the categories, the bit of a category is its position
+     * @param caseInsensitive [in] true to match ASCII letters regardless of their case
+     * @throw std::invalid_argument when there are more than #MaxCategories categories
+     */
+    explicit CategoryMatcher ( const std::vector< Category > &categories, bool caseInsensitive = false );
+
+    /**
+     * @brief The categories #url belongs to
+     */
+    Mask classify ( StringRef url ) const;
+
+    std::size_t categoryCount () const { return names.size(); }                    //< Number of categories
+    const std::string &categoryName ( std::size_t index ) const { return names[index]; } //< Name of the category #index
+
+    private:
+    KeywordMatcher matcher;               //< The keywords of every category
+    std::vector< Mask > keywordMasks;     //< The category bit of every keyword of #matcher
+    std::vector< std::string > names;     //< The category names
+  };
+
+  inline CategoryMatcher::Mask CategoryMatcher::classify ( StringRef url ) const
+  {
+    Mask mask = 0;
+    this->matcher.forEachMatch( url, [ this, &mask ] ( std::size_t keyword, std::size_t )
+    {
+      mask |= this->keywordMasks[keyword];
+    } );
+    return mask;
+  }
+
+} // namespace Qustodio
+
+#endif // CATEGORYMATCHER_HPP
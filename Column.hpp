@@ -0,0 +1,167 @@
+/** @file
+ * @brief Column
+ *
+ * This file contains the column type of the Event Store, owning its values or referencing them
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref Column_legal_note_sec
+ *
+ * @section Column_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section Column_intro_sec Introduction
+ *
+ * A column either owns its values in a std::vector or references an array that lives somewhere else, usually a mapped
+ * snapshot file. Reading is the same in both cases. The first modification of a referencing column copies the array
+ * into its own vector, so a store loaded from a snapshot can still be appended to.
+ *
+ * @section Column_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section Column_install_sec Use
+ *
+ * @subsection Column_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef COLUMN_HPP
+#define COLUMN_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class Column Column.hpp "Column.hpp"
+ *  \brief Contiguous array of trivially copyable values, owned or referenced.
+ */
+  template < class T >
+  class Column
+  {
+    public:
+    Column () = default;
+
+    Column ( std::initializer_list< T > initial )
+            : owned( initial ), values( owned.data() ), count( owned.size() )
+    { }
+
+    Column ( const Column &other )
+            : owned( other.owned ), values( other.values ), count( other.count )
+    {
+      if ( !other.referencing() )
+        this->values = this->owned.data();
+    }
+
+    Column ( Column &&other ) noexcept
+            : owned( std::move( other.owned ) ), values( other.values ), count( other.count )
+    {
+      other.values = nullptr;
+      other.count = 0;
+    }
+
+    Column &operator= ( const Column &other )
+    {
+      if ( this != & other )
+      {
+        this->owned = other.owned;
+        this->values = other.referencing() ? other.values : this->owned.data();
+        this->count = other.count;
+      }
+      return * this;
+    }
+
+    Column &operator= ( Column &&other ) noexcept
+    {
+      if ( this != & other )
+      {
+        this->owned = std::move( other.owned );
+        this->values = other.values;
+        this->count = other.count;
+        other.owned.clear();
+        other.values = nullptr;
+        other.count = 0;
+      }
+      return * this;
+    }
+
+    /**
+     * @brief References #size values at #data instead of owning them, they must outlive the column
+     */
+    void reference ( const T *data, std::size_t size )
+    {
+      std::vector< T >().swap( this->owned );
+      this->values = data;
+      this->count = size;
+    }
+
+    bool referencing () const { return this->values != this->owned.data(); } //< True when the values are not owned
+
+    std::size_t size () const { return this->count; }                //< Number of values
+    bool empty () const { return 0 == this->count; }                 //< True when there are no values
+    const T *data () const { return this->values; }                  //< First value
+    const T *begin () const { return this->values; }                 //< First value
+    const T *end () const { return this->values + this->count; }     //< One past the last value
+    const T &operator[] ( std::size_t index ) const { return this->values[index]; } //< Value #index
+    const T &back () const { return this->values[this->count - 1]; } //< Last value
+
+    /**
+     * @brief Bytes allocated by the column, zero while referencing
+     */
+    std::size_t capacity () const { return this->owned.capacity(); }
+
+    void reserve ( std::size_t size )
+    {
+      this->own();
+      this->owned.reserve( size );
+      this->values = this->owned.data();
+    }
+
+    void push_back ( const T &value )
+    {
+      this->own();
+      this->owned.push_back( value );
+      this->values = this->owned.data();
+      ++this->count;
+    }
+
+    void append ( const T *first, const T *last )
+    {
+      this->own();
+      this->owned.insert( this->owned.end(), first, last );
+      this->values = this->owned.data();
+      this->count = this->owned.size();
+    }
+
+    void clear ()
+    {
+      this->owned.clear();
+      this->values = this->owned.data();
+      this->count = 0;
+    }
+
+    private:
+    /**
+     * @brief Copies referenced values into #owned before modifying them
+     */
+    void own ()
+    {
+      if ( !this->referencing() )
+        return;
+      this->owned.assign( this->values, this->values + this->count );
+      this->values = this->owned.data();
+    }
+
+    std::vector< T > owned;      //< The values when the column owns them
+    const T *values = nullptr;   //< The values, in #owned or referenced
+    std::size_t count = 0;       //< Number of values
+  };
+
+} // namespace Qustodio
+
+#endif // COLUMN_HPP
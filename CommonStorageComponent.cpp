@@ -1,79 +1,691 @@
 #include "CommonStorageComponent.hpp"
+#include "BrowsingRecordParser.hpp"
+#include "CompressedFile.hpp"
+#include "LogFollower.hpp"
+#include "StringArena.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
 #include <iostream>
 #include <fstream>
-#include <regex>
+#include <stdexcept>
+#include <thread>
 
-void Qustodio::CommonStorageComponent::insertBrowseEvent ( const std::string &line,
-                                                           const std::string &function )
+namespace
 {
-  Qustodio::BrowsingEvent browseEvent;
+  typedef Qustodio::BrowsingRecordTokenizer Tokenizer;
 
-  std::regex rRegex( function + ": (.*)" );
-  std::smatch result;
-  std::regex_search( line, result, rRegex );
+  const char *const parseStage = "parse"; //< The stage of #readFromFiles in ComposerPool::snapshot
+  const std::size_t decompressBlockSize = 1 << 20; //< Decompressed bytes handed at once to the parser
+  const std::size_t decompressBuffers = 2;         //< Blocks going back and forth between decompression and parsing
+  const std::size_t decompressBatch = 8;           //< Decompressed blocks parsed concurrently by #readCompressed
 
-  if ( result[1].length() > 0 )
+  /**
+   * @brief A piece of a file parsed by a single task of CommonStorageComponent::readFromFiles
+   */
+  struct IngestChunk
   {
-    if ( "url" == function )
+    const char *first = nullptr;       //< First line of the piece
+    const char *last = nullptr;        //< One past its last line
+    const char *end = nullptr;         //< End of the file, the last record of the piece may go on past #last
+    const std::string *path = nullptr; //< The file to read line by line when it couldn't be mapped
+    bool compressed = false;           //< True when #path is decompressed as it is read
+    bool startsFile = false;           //< True for the first piece of a file
+    unsigned entryFields = Tokenizer::FieldNone;         //< Fields of the record left open by the previous piece
+    unsigned exitFields[ Tokenizer::FieldAll + 1 ] = {}; //< Fields left open at #last for every #entryFields
+    std::uint64_t sequence = 0;        //< The shard the piece publishes
+  };
+
+  inline const char *nextLine ( const char *line, const char *end, const char *&lineEnd )
+  {
+    lineEnd = static_cast< const char * >( std::memchr( line, '\n', static_cast< std::size_t >( end - line ) ) );
+    if ( nullptr == lineEnd )
     {
-#if SHOW_INTERMEDIATE
-      std::cout << "Insert Url: " << result[1] << std::endl;
-#endif
-      browseEvent.Url( result[1] );
+      lineEnd = end;
+      return end;
     }
-    else if ( "device" == function )
+    return lineEnd + 1;
+  }
+
+  /**
+   * @brief Parses lines that don't outlive the call, such as the buffer of std::getline, without allocating per event
+   *
+   * Every line is copied to a #StringArena of the reader and parsed in place by a #BrowsingEventViewParser. The
+   * completed records are copied into an #EventStore by the callback, so an arena is rewound, keeping its blocks,
+   * as soon as no open record references it, and freed at once with the parser.
+   *
+   * A line that closes a record because one of its fields repeats also opens the next record. That line stays in
+   * the arena it was copied to, and the next lines go to the other arena, rewound first: it only held records
+   * already completed. Each arena holds about two records whatever the length of the log.
+   */
+  class ArenaLineParser
+  {
+    public:
+    /**
+     * @brief Feeds one line, calling #onEvent with the record it completes, if any
+     */
+    template < class Callback >
+    void feedLine ( const char *first, const char *last, Callback &&onEvent )
     {
-#if SHOW_INTERMEDIATE
-      std::cout << "Insert Device: " << result[1] << std::endl;
-#endif
-      browseEvent.Device( result[1] );
+      const Qustodio::StringRef line = this->arenas[this->active].copy( first, static_cast< std::size_t >( last - first ) );
+      const bool completed = this->parser.feedLine( line.begin(), line.end() );
+      if ( completed )
+        onEvent( this->parser.takeEvent() );
+
+      if ( !this->parser.pending() )
+      {
+        this->arenas[0].rewind();
+        this->arenas[1].rewind();
+      }
+      else if ( completed )
+      {
+        this->active ^= 1;
+        this->arenas[this->active].rewind();
+      }
     }
-    else if ( "timestamp" == function )
+
+    /**
+     * @brief Feeds a buffer holding whole lines, see #feedLine
+     */
+    template < class Callback >
+    void feedBuffer ( const char *first, const char *last, Callback &&onEvent )
     {
-#if SHOW_INTERMEDIATE
-      std::cout << "Insert Timestamp: " << result[1] << std::endl;
-#endif
-      browseEvent.Timestamp( result[1] );
+      while ( first != last )
+      {
+        const char *lineEnd = static_cast< const char * >(
+                std::memchr( first, '\n', static_cast< std::size_t >( last - first ) ) );
+        if ( nullptr == lineEnd )
+          lineEnd = last;
+
+        this->feedLine( first, lineEnd, onEvent );
+        first = lineEnd == last ? last : lineEnd + 1;
+      }
     }
-    else
+
+    /**
+     * @brief Flushes the pending record at the end of the input, calling #onEvent with it
+     */
+    template < class Callback >
+    void finish ( Callback &&onEvent )
+    {
+      if ( this->parser.finish() )
+        onEvent( this->parser.takeEvent() );
+      this->arenas[0].rewind();
+      this->arenas[1].rewind();
+    }
+
+    private:
+    Qustodio::StringArena arenas[2];          //< The lines of the open record and of the one completed before it
+    unsigned active = 0;                      //< The arena the next line is copied to
+    Qustodio::BrowsingEventViewParser parser; //< Parses the lines in the #arenas
+  };
+
+  /**
+   * @brief Splits a mapped file at line boundaries in pieces of about #chunkSize bytes
+   */
+  void splitFile ( const char *data, std::size_t size, std::size_t chunkSize, std::vector< IngestChunk > &chunks )
+  {
+    const char *end = data + size;
+    const std::size_t count = size / chunkSize > 1 ? size / chunkSize : 1;
+    const char *first = data;
+
+    for ( std::size_t i = 1; i <= count; ++i )
+    {
+      const char *last = end;
+      if ( i != count )
+      {
+        const char *lineEnd = nullptr;
+        last = data + size / count * i;
+        last = last < first ? first : nextLine( last, end, lineEnd );
+      }
+      if ( last == first && i != count )
+        continue;
+
+      IngestChunk chunk;
+      chunk.first = first;
+      chunk.last = last;
+      chunk.end = end;
+      chunk.startsFile = first == data;
+      chunks.push_back( chunk );
+      first = last;
+    }
+  }
+
+  /**
+   * @brief Finds the fields left open at the end of a piece for every set of fields it may start with
+   *
+   * Only tokenizes the lines, which is enough to know how they are grouped in records.
+   */
+  void traceChunk ( IngestChunk &chunk )
+  {
+    unsigned fields[ Tokenizer::FieldAll + 1 ];
+    for ( unsigned entry = 0; entry <= Tokenizer::FieldAll; ++entry )
+      fields[entry] = entry;
+
+    const char *line = chunk.first;
+    while ( line != chunk.last )
+    {
+      const char *lineEnd = nullptr;
+      const char *next = nextLine( line, chunk.last, lineEnd );
+      const char *valueFirst = nullptr;
+      const char *valueLast = nullptr;
+      bool startsRecord = false;
+
+      const Tokenizer::Field field = Tokenizer::tokenize( line, lineEnd, valueFirst, valueLast, startsRecord );
+      for ( unsigned entry = 0; entry <= Tokenizer::FieldAll; ++entry )
+        fields[entry] = Tokenizer::advance( fields[entry], field, startsRecord );
+      line = next;
+    }
+
+    for ( unsigned entry = 0; entry <= Tokenizer::FieldAll; ++entry )
+      chunk.exitFields[entry] = fields[entry];
+  }
+
+  /**
+   * @brief Parses the records starting in a piece, the one left open at its end is completed past #IngestChunk::last
+   */
+  void parseChunk ( const IngestChunk &chunk, Qustodio::EventStore &shard )
+  {
+    // the mapping outlives the parse, the store copies the fields it keeps
+    Qustodio::BrowsingEventViewParser parser;
+    const char *line = chunk.first;
+    const char *lineEnd = nullptr;
+
+    // the record the previous piece left open is only followed to skip its lines
+    parser.resume( chunk.entryFields );
+    while ( line != chunk.last )
+    {
+      const char *next = nextLine( line, chunk.last, lineEnd );
+      if ( parser.feedLine( line, lineEnd ) )
+        shard.append( parser.takeEvent() );
+      line = next;
+    }
+
+    const bool owned = !parser.resuming();
+    bool open = parser.pending();
+    while ( open && line != chunk.end )
+    {
+      const char *next = nextLine( line, chunk.end, lineEnd );
+      if ( parser.feedLine( line, lineEnd ) )
+      {
+        shard.append( parser.takeEvent() );
+        open = false;
+      }
+      else if ( !owned && !parser.resuming() )
+        open = false;
+      line = next;
+    }
+
+    if ( open && parser.finish() )
+      shard.append( parser.takeEvent() );
+  }
+
+  /**
+   * @brief Parses the records starting in a block of whole lines that can't look past its end
+   *
+   * As #parseChunk, but the record left open at #IngestChunk::last is not completed.
+   * @param openFirst [out] the first line of the record left open, nullptr when no record starting in the block is
+   */
+  void parseBlock ( const IngestChunk &chunk, Qustodio::EventStore &store, const char *&openFirst )
+  {
+    Qustodio::BrowsingEventViewParser parser;
+    const char *line = chunk.first;
+    const char *lineEnd = nullptr;
+
+    openFirst = nullptr;
+    parser.resume( chunk.entryFields );
+    while ( line != chunk.last )
+    {
+      const char *next = nextLine( line, chunk.last, lineEnd );
+      const bool open = parser.pending();
+      const bool resumed = parser.resuming();
+      const bool completed = parser.feedLine( line, lineEnd );
+      if ( completed )
+        store.append( parser.takeEvent() );
+
+      // the line opens a record when nothing was open or it closed the open one
+      if ( parser.pending() && !parser.resuming() && ( !open || resumed || completed ) )
+        openFirst = line;
+      line = next;
+    }
+
+    if ( !parser.pending() || parser.resuming() )
+      openFirst = nullptr;
+  }
+
+  /**
+   * @brief Reads a file that can't be mapped line by line
+   * @return the bytes of the lines read
+   */
+  std::size_t readLines ( const std::string &fileToRead, Qustodio::EventStore &shard )
+  {
+    std::ifstream inp;
+    std::string line;
+    std::size_t bytes = 0;
+    ArenaLineParser parser;
+    auto onEvent = [ &shard ] ( Qustodio::BrowsingEventView &&event ) { shard.append( event ); };
+
+    inp.open( fileToRead );
+
+    if ( inp.is_open() )
+    {
+      while ( std::getline( inp, line ) )
+      {
+        // the last line may have no line break
+        bytes += line.size() + ( inp.eof() ? 0 : 1 );
+        parser.feedLine( line.data(), line.data() + line.size(), onEvent );
+      }
+      parser.finish( onEvent );
+    }
+
+    inp.close();
+    return bytes;
+  }
+
+  /**
+   * @brief Decompresses a file on a thread of its own, calling #onBlock with every block of whole lines in order
+   *
+   * Two buffers go back and forth between the threads through a pair of #BoundedChannel: while #onBlock parses
+   * one, the other is being filled, so the decompression is not serialized in front of the parse and the memory
+   * stays bounded whatever the size of the file. A line cut by the end of a buffer starts the next one.
+   * @param fileToRead [in] a file CompressedFile reads
+   * @param onBlock [in] callable taking the `std::vector< char > &` of a block, false to stop. It may swap the block
+   * for another buffer to keep it, the decompressor then fills that one
+   * @throw std::runtime_error when the format is not supported by the build or the data is corrupt
+   */
+  template < class Callback >
+  void decompressBlocks ( const std::string &fileToRead, Callback &&onBlock )
+  {
+    Qustodio::CompressedFile file;
+    if ( !file.open( fileToRead ) )
+      throw std::runtime_error( "CommonStorageComponent: can't decompress " + fileToRead );
+
+    Qustodio::BoundedChannel< std::vector< char >> filled( decompressBuffers );
+    Qustodio::BoundedChannel< std::vector< char >> empty( decompressBuffers );
+    for ( std::size_t b = 0; b != decompressBuffers; ++b )
+      empty.push( std::vector< char >() );
+
+    std::exception_ptr error;
+    std::thread decompressor( [ &file, &filled, &empty, &error ]
+    {
+      std::vector< char > carry;
+      std::vector< char > block;
+      bool end = false;
+      try
+      {
+        while ( !end && empty.pop( block ) )
+        {
+          block.resize( std::max( decompressBlockSize, carry.size() * 2 ) );
+          std::copy( carry.begin(), carry.end(), block.begin() );
+          std::size_t size = carry.size();
+          std::size_t cut = 0;
+
+          // full buffers are cut after their last line break, and grow when a line doesn't fit
+          while ( 0 == cut && !end )
+          {
+            if ( size == block.size() )
+              block.resize( block.size() * 2 );
+
+            const std::size_t count = file.read( block.data() + size, block.size() - size );
+            size += count;
+            if ( 0 == count )
+            {
+              end = true;
+              cut = size;
+            }
+            else if ( size == block.size() )
+            {
+              const auto lineEnd = std::find( block.rbegin(), block.rend(), '\n' );
+              cut = static_cast< std::size_t >( block.rend() - lineEnd );
+            }
+          }
+
+          carry.assign( block.begin() + static_cast< std::ptrdiff_t >( cut ),
+                        block.begin() + static_cast< std::ptrdiff_t >( size ) );
+          block.resize( cut );
+          if ( 0 != cut && !filled.push( std::move( block ) ) )
+            break;
+        }
+      }
+      catch ( ... )
+      {
+        error = std::current_exception();
+      }
+      filled.close();
+    } );
+
+    // closing both channels stops the decompressor whatever it waits for
+    auto stop = [ &filled, &empty, &decompressor ]
+    {
+      empty.close();
+      filled.close();
+      decompressor.join();
+    };
+
+    try
     {
-      throw std::invalid_argument( "Invalid function" );
+      std::vector< char > block;
+      while ( filled.pop( block ) && onBlock( block ) )
+        empty.push( std::move( block ) );
     }
+    catch ( ... )
     {
-      std::lock_guard< std::mutex > lock( this->browsingEventMutex );
-      this->browsingEvent->emplace_back( browseEvent );
+      stop();
+      throw;
     }
+
+    stop();
+    if ( error )
+      std::rethrow_exception( error );
+  }
+
+  /**
+   * @brief Reads a compressed file, decompressing it while it is parsed
+   *
+   * The decompressed blocks are parsed #decompressBatch at a time by the tasks of #pool, as the pieces of a mapped
+   * file: #traceChunk finds the fields every block starts with and #parseBlock parses each one to a store of its
+   * own. The record a block leaves open only needs the first lines of the next blocks, so it is completed here by
+   * an owning parser, in order, and the blocks are released once their batch is added to #shard.
+   * @return the decompressed bytes parsed
+   */
+  std::size_t readCompressed ( Qustodio::ComposerPool &pool, const std::string &fileToRead, Qustodio::EventStore &shard )
+  {
+    std::vector< std::vector< char >> blocks;
+    std::vector< std::vector< char >> spare;
+    std::vector< IngestChunk > chunks( decompressBatch );
+    std::vector< Qustodio::EventStore > stores( decompressBatch );
+    std::vector< const char * > openFirsts( decompressBatch );
+    unsigned entryFields = Tokenizer::FieldNone;
+    Qustodio::BrowsingRecordParser open;
+    bool pending = false;
+    std::size_t bytes = 0;
+
+    auto parseBatch = [ & ]
+    {
+      const std::size_t count = blocks.size();
+      for ( std::size_t b = 0; b != count; ++b )
+      {
+        chunks[b].first = blocks[b].data();
+        chunks[b].last = blocks[b].data() + blocks[b].size();
+        chunks[b].end = chunks[b].last;
+      }
+
+      pool.parallel_for( 0, count, 1, [ &chunks ] ( std::size_t b ) { traceChunk( chunks[b] ); } ).get();
+      for ( std::size_t b = 0; b != count; ++b )
+      {
+        chunks[b].entryFields = entryFields;
+        entryFields = chunks[b].exitFields[entryFields];
+      }
+      pool.parallel_for( 0, count, 1, [ &chunks, &stores, &openFirsts ] ( std::size_t b )
+      {
+        parseBlock( chunks[b], stores[b], openFirsts[b] );
+      } ).get();
+
+      for ( std::size_t b = 0; b != count; ++b )
+      {
+        const char *line = chunks[b].first;
+        const char *lineEnd = nullptr;
+
+        // the record left open before goes on in the first lines of this block, or in all of them
+        while ( pending && line != chunks[b].last )
+        {
+          const char *next = nextLine( line, chunks[b].last, lineEnd );
+          if ( open.feedLine( line, lineEnd ) )
+          {
+            shard.append( open.takeEvent() );
+            pending = false;
+          }
+          line = next;
+        }
+
+        shard.append( std::move( stores[b] ) );
+
+        if ( nullptr != openFirsts[b] )
+        {
+          open.resume( Tokenizer::FieldNone );
+          for ( line = openFirsts[b]; line != chunks[b].last; )
+          {
+            const char *next = nextLine( line, chunks[b].last, lineEnd );
+            open.feedLine( line, lineEnd );
+            line = next;
+          }
+          pending = true;
+        }
+      }
+
+      // the buffers go back to the decompressor
+      for ( auto &&block: blocks )
+        spare.push_back( std::move( block ) );
+      blocks.clear();
+    };
+
+    decompressBlocks( fileToRead, [ & ] ( std::vector< char > &block )
+    {
+      bytes += block.size();
+      blocks.push_back( std::vector< char >() );
+      blocks.back().swap( block );
+      if ( !spare.empty() )
+      {
+        block.swap( spare.back() );
+        spare.pop_back();
+      }
+
+      if ( blocks.size() == decompressBatch )
+        parseBatch();
+      return true;
+    } );
+
+    if ( !blocks.empty() )
+      parseBatch();
+    if ( pending && open.finish() )
+      shard.append( open.takeEvent() );
+    return bytes;
   }
-  std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+} // namespace
+
+Qustodio::CommonStorageComponent::CommonStorageComponent ( IngestionOrder order )
+        : order( order )
+{
 }
 
-void Qustodio::CommonStorageComponent::readFromFile ( const std::string &fileToRead )
+std::uint64_t Qustodio::CommonStorageComponent::beginShard ( std::uint64_t count )
 {
-  std::ifstream inp;
-  std::string line;
+  return this->nextShard.fetch_add( count );
+}
+
+void Qustodio::CommonStorageComponent::publishShard ( std::uint64_t sequence, Qustodio::EventStore &&shard )
+{
+  std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+
+  if ( IngestionOrder::Completion == this->order )
+  {
+    this->publishSegment( std::move( shard ) );
+    return;
+  }
+
+  if ( sequence != this->nextPublished )
+  {
+    this->pendingShards.emplace( sequence, std::move( shard ) );
+    return;
+  }
+
+  this->publishSegment( std::move( shard ) );
+  ++this->nextPublished;
+
+  // the shards that were waiting for this one
+  for ( auto next = this->pendingShards.begin();
+        next != this->pendingShards.end() && next->first == this->nextPublished;
+        next = this->pendingShards.erase( next ) )
+  {
+    this->publishSegment( std::move( next->second ) );
+    ++this->nextPublished;
+  }
+}
+
+void Qustodio::CommonStorageComponent::publishSegment ( Qustodio::EventStore &&shard )
+{
+  if ( shard.empty() )
+    return;
+
+  std::shared_ptr< const Qustodio::EventVersion > current = std::atomic_load( & this->published );
+  std::vector< Qustodio::EventVersion::Segment > segments;
+  for ( std::size_t s = 0; s != current->segmentCount(); ++s )
+    segments.push_back( current->segment( s ) );
+
+  segments.push_back( std::make_shared< Qustodio::EventStore >( std::move( shard ) ) );
+  this->segmentLevels.push_back( 0 );
+
+  // every #segmentFanIn segments of the same level are merged into one of the next level, unless they are evicted
+  while ( !this->retaining() && segments.size() >= segmentFanIn )
+  {
+    const std::size_t first = segments.size() - segmentFanIn;
+    const unsigned level = this->segmentLevels.back();
+    if ( this->segmentLevels[first] != level )
+      break;
+
+    auto merged = std::make_shared< Qustodio::EventStore >();
+    for ( std::size_t s = first; s != segments.size(); ++s )
+      merged->append( * segments[s] );
+    segments.resize( first );
+    segments.push_back( merged );
+    this->segmentLevels.resize( first );
+    this->segmentLevels.push_back( level + 1 );
+  }
+
+  std::vector< Qustodio::EventVersion::Segment > evicted;
+  this->evictSegments( segments, evicted );
+
+  // the readers of the previous version keep it, and its segments, alive
+  std::atomic_store( & this->published, std::shared_ptr< const Qustodio::EventVersion >(
+          std::make_shared< const Qustodio::EventVersion >( current->version() + 1, std::move( segments ) ) ) );
+  current.reset();
+  this->recycleSegments( evicted );
+}
+
+void Qustodio::CommonStorageComponent::setRetention ( const RetentionPolicy &policy )
+{
+  std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+  this->retentionPolicy = policy;
+
+  std::shared_ptr< const Qustodio::EventVersion > current = std::atomic_load( & this->published );
+  std::vector< Qustodio::EventVersion::Segment > segments;
+  for ( std::size_t s = 0; s != current->segmentCount(); ++s )
+    segments.push_back( current->segment( s ) );
+
+  std::vector< Qustodio::EventVersion::Segment > evicted;
+  this->evictSegments( segments, evicted );
+  if ( evicted.empty() )
+    return;
+
+  std::atomic_store( & this->published, std::shared_ptr< const Qustodio::EventVersion >(
+          std::make_shared< const Qustodio::EventVersion >( current->version() + 1, std::move( segments ) ) ) );
+  current.reset();
+  this->recycleSegments( evicted );
+}
+
+bool Qustodio::CommonStorageComponent::retaining () const
+{
+  return this->retentionPolicy.maxAgeSeconds > 0 || this->retentionPolicy.maxBytes > 0;
+}
 
-  inp.open( fileToRead );
+void Qustodio::CommonStorageComponent::evictSegments ( std::vector< Qustodio::EventVersion::Segment > &segments,
+                                                       std::vector< Qustodio::EventVersion::Segment > &evicted )
+{
+  std::size_t count = 0;
+
+  if ( this->retentionPolicy.maxAgeSeconds > 0 )
+  {
+    std::int64_t latest = Qustodio::EventStore::InvalidTimestamp;
+    for ( auto &&segment: segments )
+      latest = std::max( latest, segment->latestTimestamp() );
+
+    // the segments are in input order, so the old ones are at the front of a log ordered by time
+    if ( Qustodio::EventStore::InvalidTimestamp != latest )
+      while ( count + 1 < segments.size() )
+      {
+        const std::int64_t newest = segments[count]->latestTimestamp();
+        if ( Qustodio::EventStore::InvalidTimestamp == newest || newest >= latest - this->retentionPolicy.maxAgeSeconds )
+          break;
+        ++count;
+      }
+  }
 
-  if ( inp.is_open() )
+  if ( this->retentionPolicy.maxBytes > 0 )
   {
-    while ( inp.good() )
+    std::size_t bytes = 0;
+    for ( std::size_t s = count; s < segments.size(); ++s )
+      bytes += segments[s]->memoryUsage();
+    for ( ; count + 1 < segments.size() && bytes > this->retentionPolicy.maxBytes; ++count )
+      bytes -= segments[count]->memoryUsage();
+  }
+
+  evicted.assign( segments.begin(), segments.begin() + count );
+  segments.erase( segments.begin(), segments.begin() + count );
+  this->segmentLevels.erase( this->segmentLevels.begin(), this->segmentLevels.begin() + count );
+}
+
+void Qustodio::CommonStorageComponent::recycleSegments ( std::vector< Qustodio::EventVersion::Segment > &evicted )
+{
+  for ( auto &&segment: evicted )
+    this->evictedSegments.push_back( std::move( segment ) );
+  evicted.clear();
+
+  std::size_t kept = 0;
+  for ( auto &&segment: this->evictedSegments )
+  {
+    // once the published version no longer holds it, only older versions can, and they are never published again
+    if ( 1 != segment.use_count() )
     {
-      std::getline( inp, line );
-      pool.enqueue( & Qustodio::CommonStorageComponent::insertBrowseEvent, this, line, "url" );
-      pool.enqueue( & Qustodio::CommonStorageComponent::insertBrowseEvent, this, line, "device" );
-      pool.enqueue( & Qustodio::CommonStorageComponent::insertBrowseEvent, this, line, "timestamp" );
+      this->evictedSegments[kept++] = std::move( segment );
+      continue;
     }
+    if ( this->recycledSegments.size() >= recycledLimit )
+    {
+      segment.reset();
+      continue;
+    }
+    // use_count is a relaxed load, the reads of the last reader that released it must happen before the clear
+    std::atomic_thread_fence( std::memory_order_acquire );
+
+    // the segments are built mutable by #publishSegment and nobody else can see this one anymore
+    std::shared_ptr< Qustodio::EventStore > store = std::const_pointer_cast< Qustodio::EventStore >( segment );
+    segment.reset();
+    store->clear();
+    this->recycledSegments.push_back( std::move( store ) );
   }
+  this->evictedSegments.resize( kept );
+}
+
+Qustodio::EventStore Qustodio::CommonStorageComponent::takeShard ()
+{
+  std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+  // the readers may have released the segments evicted while they held them
+  std::vector< Qustodio::EventVersion::Segment > evicted;
+  this->recycleSegments( evicted );
+  if ( this->recycledSegments.empty() )
+    return Qustodio::EventStore();
 
-  pool.wait_until_empty();
-  pool.wait_until_nothing_in_flight();
+  // the columns keep their capacity
+  Qustodio::EventStore shard( std::move( * this->recycledSegments.back() ) );
+  this->recycledSegments.pop_back();
+  this->recycledShards.fetch_add( 1, std::memory_order_relaxed );
+  return shard;
+}
 
-  inp.close();
+std::uint64_t Qustodio::CommonStorageComponent::RecycledShards () const
+{
+  return this->recycledShards.load( std::memory_order_relaxed );
+}
+
+void Qustodio::CommonStorageComponent::readFromFile ( const std::string &fileToRead )
+{
+  this->readFromFiles( std::vector< std::string >( 1, fileToRead ) );
 
   #if SHOW_INTERMEDIATE
   std::cout << "Results" << std::endl;
-  for ( auto &&result: * this->browsingEvent )
+  for ( auto &&result: * this->Events() )
   {
     std::cout << result.Url();
     if ( result.Url().length() > 0 )
@@ -84,8 +696,287 @@ void Qustodio::CommonStorageComponent::readFromFile ( const std::string &fileToR
   #endif
 }
 
-const std::shared_ptr< std::vector< Qustodio::BrowsingEvent>> &
-Qustodio::CommonStorageComponent::BrowsingEvent () const
+void Qustodio::CommonStorageComponent::readFromFiles ( const std::vector< std::string > &filesToRead )
+{
+  std::vector< std::unique_ptr< Qustodio::MappedFile >> mappings;
+  std::vector< IngestChunk > chunks;
+
+  for ( const std::string &fileToRead: filesToRead )
+  {
+    // a compressed file is decompressed by a single task, which hands its blocks to the others
+    if ( Qustodio::CompressedFile::Format::Plain != Qustodio::CompressedFile::detect( fileToRead ) )
+    {
+      IngestChunk chunk;
+      chunk.path = &fileToRead;
+      chunk.compressed = true;
+      chunk.startsFile = true;
+      chunks.push_back( chunk );
+      continue;
+    }
+
+    std::unique_ptr< Qustodio::MappedFile > mapping( new Qustodio::MappedFile );
+    if ( mapping->open( fileToRead ) )
+    {
+      splitFile( mapping->data(), mapping->size(), ingestChunkSize, chunks );
+      mappings.push_back( std::move( mapping ) );
+    }
+    else
+    {
+      IngestChunk chunk;
+      chunk.path = &fileToRead;
+      chunk.startsFile = true;
+      chunks.push_back( chunk );
+    }
+  }
+
+  if ( chunks.empty() )
+    return;
+
+  // the shards of the read are consecutive even if other reads start meanwhile
+  const std::uint64_t firstSequence = this->beginShard( chunks.size() );
+
+  this->pool.parallel_for( 0, chunks.size(), 1, [ &chunks ] ( std::size_t i )
+  {
+    if ( nullptr == chunks[i].path )
+      traceChunk( chunks[i] );
+  } ).get();
+
+  for ( std::size_t i = 0; i != chunks.size(); ++i )
+  {
+    chunks[i].sequence = firstSequence + i;
+    if ( !chunks[i].startsFile )
+      chunks[i].entryFields = chunks[i - 1].exitFields[chunks[i - 1].entryFields];
+  }
+
+  // every shard is published even if a piece fails, the later reads wait for them
+  std::vector< std::exception_ptr > errors( chunks.size() );
+  this->pool.parallel_for( 0, chunks.size(), 1, [ this, &chunks, &errors ] ( std::size_t i )
+  {
+    Qustodio::ComposerPool::stage_timer timer( this->pool, parseStage );
+    Qustodio::EventStore shard = this->takeShard();
+    // the bytes of the piece, or the bytes read or decompressed when it is not mapped
+    std::size_t bytes = static_cast< std::size_t >( chunks[i].last - chunks[i].first );
+    try
+    {
+      if ( nullptr == chunks[i].path )
+        parseChunk( chunks[i], shard );
+      else if ( chunks[i].compressed )
+        bytes = readCompressed( this->pool, * chunks[i].path, shard );
+      else
+        bytes = readLines( * chunks[i].path, shard );
+    }
+    catch ( ... )
+    {
+      errors[i] = std::current_exception();
+      shard.clear();
+    }
+    timer.add( shard.size(), bytes );
+    this->publishShard( chunks[i].sequence, std::move( shard ) );
+  } ).get();
+
+  for ( const std::exception_ptr &error: errors )
+    if ( error )
+      std::rethrow_exception( error );
+}
+
+void Qustodio::CommonStorageComponent::streamFromFile ( const std::string &fileToRead,
+                                                       Qustodio::BoundedChannel< Qustodio::EventStore > &channel,
+                                                       std::size_t batchSize )
+{
+  std::ifstream inp;
+  std::string line;
+  ArenaLineParser parser;
+  Qustodio::EventStore batch;
+  bool consumed = true;
+  auto onEvent = [ &batch, &channel, &consumed, batchSize ] ( Qustodio::BrowsingEventView &&event )
+  {
+    batch.append( event );
+    // waits here while the consumer is behind
+    if ( batch.size() >= batchSize )
+    {
+      consumed = channel.push( std::move( batch ) );
+      batch.clear();
+    }
+  };
+
+  if ( Qustodio::CompressedFile::Format::Plain != Qustodio::CompressedFile::detect( fileToRead ) )
+  {
+    try
+    {
+      decompressBlocks( fileToRead, [ &parser, &onEvent, &consumed ] ( std::vector< char > &block )
+      {
+        parser.feedBuffer( block.data(), block.data() + block.size(), onEvent );
+        return consumed;
+      } );
+    }
+    catch ( ... )
+    {
+      channel.close();
+      throw;
+    }
+  }
+  else
+  {
+    inp.open( fileToRead );
+    if ( !inp.is_open() )
+    {
+      channel.close();
+      return;
+    }
+
+    while ( consumed && std::getline( inp, line ) )
+      parser.feedLine( line.data(), line.data() + line.size(), onEvent );
+    inp.close();
+  }
+
+  if ( consumed )
+    parser.finish( onEvent );
+  if ( consumed && !batch.empty() )
+    channel.push( std::move( batch ) );
+  channel.close();
+}
+
+bool Qustodio::CommonStorageComponent::followFile ( const std::string &fileToFollow,
+                                                   Qustodio::BoundedChannel< Qustodio::EventStore > &channel,
+                                                   bool fromStart, std::size_t batchSize )
+{
+  Qustodio::LogFollower follower;
+  if ( !follower.open( fileToFollow, fromStart ) )
+  {
+    channel.close();
+    return false;
+  }
+
+  // the open record outlives the polled lines in the arena of the parser
+  ArenaLineParser parser;
+  Qustodio::EventStore batch;
+  std::vector< char > lines;
+  bool consumed = true;
+
+  while ( consumed && !channel.closed() )
+  {
+    lines.clear();
+    if ( 0 == follower.poll( followPollMilliseconds, lines ) )
+      continue;
+
+    parser.feedBuffer( lines.data(), lines.data() + lines.size(),
+                       [ &batch, &channel, &consumed, batchSize ] ( Qustodio::BrowsingEventView &&event )
+                       {
+                         batch.append( event );
+                         if ( consumed && batch.size() >= batchSize )
+                         {
+                           consumed = channel.push( std::move( batch ) );
+                           batch.clear();
+                         }
+                       } );
+
+    // the consumer sees the new events without waiting for a full batch
+    if ( consumed && !batch.empty() )
+    {
+      consumed = channel.push( std::move( batch ) );
+      batch.clear();
+    }
+  }
+
+  channel.close();
+  return true;
+}
+
+void Qustodio::CommonStorageComponent::readFromMappedFile ( const std::string &fileToRead )
+{
+  auto mapping = std::make_shared< Qustodio::MappedFile >();
+
+  if ( !mapping->open( fileToRead ) )
+    return;
+
+  Qustodio::BrowsingEventViewParser parser;
+  std::vector< Qustodio::BrowsingEventView > parsed;
+
+  parser.feedBuffer( mapping->data(), mapping->data() + mapping->size(),
+                     [ &parsed ] ( Qustodio::BrowsingEventView &&event ) { parsed.push_back( event ); } );
+  if ( parser.finish() )
+    parsed.push_back( parser.takeEvent() );
+
+  std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+  this->mappedFiles.push_back( mapping );
+
+  // the filters still scanning the previous vector keep it
+  const std::shared_ptr< const std::vector< Qustodio::BrowsingEventView >> current =
+          std::atomic_load( & this->mappedEvents );
+  if ( !current->empty() )
+    parsed.insert( parsed.begin(), current->begin(), current->end() );
+  std::atomic_store( & this->mappedEvents, std::shared_ptr< const std::vector< Qustodio::BrowsingEventView >>(
+          std::make_shared< const std::vector< Qustodio::BrowsingEventView >>( std::move( parsed ) ) ) );
+}
+
+bool Qustodio::CommonStorageComponent::saveSnapshot ( const std::string &fileToWrite )
+{
+  return this->Events()->save( fileToWrite );
+}
+
+bool Qustodio::CommonStorageComponent::loadSnapshot ( const std::string &fileToRead )
+{
+  Qustodio::EventStore shard;
+  const std::uint64_t sequence = this->beginShard();
+  const bool loaded = shard.load( fileToRead );
+
+  // an invalid snapshot still publishes its empty shard, the later ones wait for it
+  this->publishShard( sequence, std::move( shard ) );
+  return loaded;
+}
+
+std::shared_ptr< const Qustodio::EventVersion > Qustodio::CommonStorageComponent::Published () const
+{
+  return std::atomic_load( & this->published );
+}
+
+std::shared_ptr< const Qustodio::EventStore > Qustodio::CommonStorageComponent::Events ()
+{
+  const std::shared_ptr< const Qustodio::EventVersion > current = std::atomic_load( & this->published );
+  if ( 0 == current->segmentCount() )
+    return std::make_shared< const Qustodio::EventStore >();
+  if ( 1 == current->segmentCount() )
+    return current->segment( 0 );
+
+  {
+    std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+    std::shared_ptr< const Qustodio::EventStore > previous = this->mergedEvents.lock();
+    if ( previous && this->mergedVersion == current->version() )
+      return previous;
+  }
+
+  // the version never changes, so the reads publish their shards while it is merged
+  auto merged = std::make_shared< Qustodio::EventStore >();
+  for ( std::size_t s = 0; s != current->segmentCount(); ++s )
+    merged->append( * current->segment( s ) );
+
+  std::lock_guard< std::mutex > lock( this->browsingEventMutex );
+  // the segments stay apart so they can still be evicted
+  if ( this->retaining() )
+  {
+    this->mergedEvents = merged;
+    this->mergedVersion = current->version();
+    return merged;
+  }
+
+  // a read published meanwhile, its version keeps the segments this merge would replace
+  if ( std::atomic_load( & this->published ) != current )
+    return merged;
+
+  // same events in a new layout, a new version for the readers that compare them
+  this->segmentLevels.assign( 1, * std::max_element( this->segmentLevels.begin(), this->segmentLevels.end() ) + 1 );
+  std::atomic_store( & this->published, std::shared_ptr< const Qustodio::EventVersion >(
+          std::make_shared< const Qustodio::EventVersion >(
+                  current->version() + 1, std::vector< Qustodio::EventVersion::Segment >( 1, merged ) ) ) );
+  return merged;
+}
+
+std::shared_ptr< const std::vector< Qustodio::BrowsingEventView>> Qustodio::CommonStorageComponent::MappedEvents () const
+{
+  return std::atomic_load( & this->mappedEvents );
+}
+
+Qustodio::ComposerPool &Qustodio::CommonStorageComponent::Pool ()
 {
-  return browsingEvent;
+  return pool;
 }
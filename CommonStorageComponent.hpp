@@ -28,8 +28,16 @@
 #ifndef COMMONSTORAGECOMPONENT_HPP
 #define COMMONSTORAGECOMPONENT_HPP
 
+#include "BoundedChannel.hpp"
 #include "BrowsingEvent.hpp"
+#include "BrowsingEventView.hpp"
 #include "ComposerPool.hpp"
+#include "EventStore.hpp"
+#include "EventVersion.hpp"
+#include "MappedFile.hpp"
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -45,33 +53,250 @@ namespace Qustodio
   class CommonStorageComponent
   {
     public:
+    /**
+     * @brief Order in which concurrent readers publish their events to the #EventStore
+     */
+    enum class IngestionOrder
+    {
+      Input,     //< In the order the reads started, so the events of every device keep the input order
+      Completion //< As soon as each read finishes
+    };
+
+    /**
+     * @brief Which segments of the #EventVersion are kept in memory, the oldest ones are evicted as a whole
+     */
+    struct RetentionPolicy
+    {
+      std::int64_t maxAgeSeconds = 0; //< Evict the segments older than this before the newest event, 0 keeps them all
+      std::size_t maxBytes = 0;       //< Evict the oldest segments while EventStore::memoryUsage adds up to more, 0 keeps them all
+    };
+
     CommonStorageComponent () = default;
 
+    /**
+     * @brief Constructor choosing how concurrent reads are ordered in the #EventStore
+     * @param order [in] the #IngestionOrder of the published events
+     */
+    explicit CommonStorageComponent ( IngestionOrder order );
+
     ~CommonStorageComponent () = default;
 
     /**
      * @brief Reads from a file to the CommonStorageComponent
+     *
+     * The file is mapped and split in pieces of about #ingestChunkSize bytes parsed concurrently by the #pool, see
+     * #readFromFiles. Files that can't be mapped, such as pipes, are read line by line, and gzip compressed files are
+     * decompressed while they are parsed.
      * @param fileToRead the file to read
      */
     void readFromFile ( const std::string &fileToRead );
 
-    const std::shared_ptr< std::vector< BrowsingEvent>> &BrowsingEvent () const;
+    /**
+     * @brief Reads several files to the CommonStorageComponent, such as a folder of daily logs
+     *
+     * Every file is split at line boundaries in pieces of about #ingestChunkSize bytes, and all the pieces of all
+     * the files are parsed concurrently by the #pool, each one to its own shard. A record cut by a piece boundary is
+     * assembled by the piece where it starts: a first quick pass finds which fields every piece starts with, so
+     * records are grouped exactly as a sequential read would group them. Every piece is published as one more shard,
+     * with #IngestionOrder::Input in the order of the files and of the pieces within them.
+     *
+     * A gzip compressed file, see CompressedFile, is read without writing it to disk: a thread of its own
+     * decompresses it block by block while the tasks of the #pool parse the blocks decompressed before, several at a
+     * time, grouping their records as the pieces of a mapped file. Each compressed file is published as a single
+     * shard.
+     * @param filesToRead the files to read
+     * @throw std::runtime_error when a compressed file is not supported by the build or is corrupt, after publishing
+     * the events of the other files
+     */
+    void readFromFiles ( const std::vector< std::string > &filesToRead );
+
+    /**
+     * @brief Maps a file in memory and reads it to the CommonStorageComponent without copying the fields
+     *
+     * The events are stored in #MappedEvents and reference the mapping, which is kept alive by this component.
+     * @param fileToRead the file to read
+     */
+    void readFromMappedFile ( const std::string &fileToRead );
+
+    /**
+     * @brief Reads a file and pushes its events through #channel in batches instead of storing them
+     *
+     * Meant to run on its own thread while a consumer such as FilterEvents::filterStream pops the batches, so the
+     * memory stays bounded by the queue size limit of the channel whatever the size of the file. The channel is
+     * closed when the file ends. A compressed file is decompressed on another thread while it is parsed, as
+     * #readFromFiles does.
+     * @param fileToRead the file to read
+     * @param channel [in,out] where the batches are pushed
+     * @param batchSize [in] events per pushed #EventStore
+     */
+    void streamFromFile ( const std::string &fileToRead, Qustodio::BoundedChannel< Qustodio::EventStore > &channel,
+                          std::size_t batchSize = streamBatchSize );
+
+    /**
+     * @brief Follows a growing log and pushes the events appended to it through #channel until the channel is closed
+     *
+     * Only the new bytes are parsed, a record split between two writes is completed with the next one, and
+     * truncated or rotated logs are followed as described in #LogFollower. Every poll that brings new events pushes
+     * them at once, so a consumer such as FilterEvents::filterStream updates its count incrementally. Closing the
+     * channel from any thread stops the follower within #followPollMilliseconds.
+     * @param fileToFollow the log to follow
+     * @param channel [in,out] where the batches are pushed
+     * @param fromStart [in] true to read the lines already in the log, false to read only the appended ones
+     * @param batchSize [in] most events per pushed #EventStore
+     * @return false when the log can't be followed, the channel is closed anyway
+     */
+    bool followFile ( const std::string &fileToFollow, Qustodio::BoundedChannel< Qustodio::EventStore > &channel,
+                      bool fromStart = true, std::size_t batchSize = streamBatchSize );
+
+    /**
+     * @brief Writes the events of the #EventStore to a binary snapshot, see EventStore::save
+     * @param fileToWrite the snapshot file
+     * @return false when the file can't be written
+     */
+    bool saveSnapshot ( const std::string &fileToWrite );
+
+    /**
+     * @brief Adds the events of a snapshot written by #saveSnapshot, without parsing them again
+     *
+     * Loading into an empty component only maps the file, see EventStore::load. The snapshot is published as one more
+     * shard, like the events of #readFromFile.
+     * @param fileToRead the snapshot file
+     * @return false when the file is not a valid snapshot
+     */
+    bool loadSnapshot ( const std::string &fileToRead );
+
+    /**
+     * @brief Bounds the events kept in memory, for components that run for days
+     *
+     * Every publication evicts the oldest segments whose newest event is more than RetentionPolicy::maxAgeSeconds
+     * older than the newest event of the component, the logs carry their own time, and then the oldest segments
+     * while the component uses more than RetentionPolicy::maxBytes. The newest segment is never evicted and the
+     * segments without any valid timestamp never age.
+     *
+     * An evicted segment is freed, or recycled for a later read once no reader holds it, as a whole: no event is freed
+     * on its own and nothing is compacted. While a policy is set the segments are never merged, so they keep the size
+     * of the pieces of #readFromFiles, about #ingestChunkSize bytes of log each. The policy applies at once.
+     * @param policy [in] the limits, the default one keeps every event
+     */
+    void setRetention ( const RetentionPolicy &policy );
+
+    /**
+     * @brief The current #EventVersion, without any lock
+     *
+     * Every read publishes its shards as new immutable segments, so the returned version never changes and can be
+     * scanned while the reads go on. As in a size-tiered log, every #segmentFanIn segments of the same level are merged
+     * into one of the next level, so a version holds a logarithmic number of segments and every event is copied a
+     * logarithmic number of times.
+     */
+    std::shared_ptr< const Qustodio::EventVersion > Published () const;
+
+    /**
+     * @brief The events read with #readFromFile, merged in a single immutable #EventStore
+     *
+     * A convenience for the callers that want a single store, the scans go through the segments of #Published
+     * instead. Merges the segments of the current #EventVersion, if there are several, outside the lock of the reads,
+     * and publishes the merged store as the next version, of a single segment, when no read published meanwhile, so
+     * the next calls are free until more events are read. The store never changes afterwards, the reads that go on
+     * publish newer versions. With a #RetentionPolicy the segments stay apart for the evictions and every call merges a copy,
+     * shared with the other callers while they hold it.
+     */
+    std::shared_ptr< const Qustodio::EventStore > Events ();
+
+    /**
+     * @brief The events read with #readFromMappedFile, an immutable vector replaced by every new read
+     */
+    std::shared_ptr< const std::vector< Qustodio::BrowsingEventView>> MappedEvents () const;
+
+    /**
+     * @brief Number of shards that reused the memory of an evicted segment, see #setRetention
+     */
+    std::uint64_t RecycledShards () const;
+
+    /**
+     * @brief The thread pool of the reads, for its ComposerPool::snapshot and ComposerPool::dump_statistics
+     *
+     * #readFromFiles records the events and bytes of every piece it parses as the "parse" stage of the pool.
+     */
+    Qustodio::ComposerPool &Pool ();
 
     private:
     /**
-     * @brief Method to insert a #BrowseEvent in the shared_ptr vector giving the #function name
-     * @param line [in] the line to inspect
-     * @param function [in] the name of the function to select
+     * @brief Reserves the position of some consecutive shards in the #EventStore
+     * @param count [in] the number of shards
+     * @return the sequence number to publish the first shard with, the next ones follow it
+     */
+    std::uint64_t beginShard ( std::uint64_t count = 1 );
+
+    /**
+     * @brief Publishes a shard filled without locking as a new segment of the #EventVersion
+     *
+     * With #IngestionOrder::Input the shard waits in #pendingShards until every shard with a lower sequence number
+     * has been published.
+     * @param sequence [in] the number returned by #beginShard
+     * @param shard [in,out] the events of a single reader, left empty on return
+     */
+    void publishShard ( std::uint64_t sequence, Qustodio::EventStore &&shard );
+
+    /**
+     * @brief Publishes a new #EventVersion with #shard as its last segment, merging the segments as described in
+     * #Published, with the #browsingEventMutex held
      */
-    void insertBrowseEvent ( const std::string &line, const std::string &function );
+    void publishSegment ( Qustodio::EventStore &&shard );
+
+    /**
+     * @brief True when a #RetentionPolicy is set
+     */
+    bool retaining () const;
+
+    /**
+     * @brief Removes from #segments, and from #segmentLevels, the oldest segments the #retentionPolicy evicts
+     * @param segments [in,out] the segments of the next version
+     * @param evicted [out] the evicted segments
+     */
+    void evictSegments ( std::vector< Qustodio::EventVersion::Segment > &segments,
+                         std::vector< Qustodio::EventVersion::Segment > &evicted );
+
+    /**
+     * @brief Keeps the memory of the #evicted segments no version references anymore for #takeShard
+     *
+     * The segments a reader still holds wait in #evictedSegments, every call and every #takeShard looks at them again.
+     * @param evicted [in,out] the segments just evicted, left empty on return
+     */
+    void recycleSegments ( std::vector< Qustodio::EventVersion::Segment > &evicted );
+
+    /**
+     * @brief An empty shard, reusing the memory of an evicted segment when there is one
+     */
+    Qustodio::EventStore takeShard ();
+
+    static const std::size_t streamBatchSize = 4096; //< Events per batch of #streamFromFile
+    static const int followPollMilliseconds = 200;    //< Longest wait of #followFile before looking at its channel
+    static const std::size_t ingestChunkSize = 4 << 20; //< Bytes parsed by every task of #readFromFiles
+    static const std::size_t segmentFanIn = 8;          //< Segments of a level merged into one of the next level
+    static const std::size_t recycledLimit = 8;         //< Most evicted segments kept for #takeShard
 
     ComposerPool pool;             //< The thread pool to launch the insertions
     std::mutex browsingEventMutex; //< The synchronize mechanism to make insertions sequentially
 
-    // Can't be auto!
-    std::shared_ptr <std::vector< Qustodio::BrowsingEvent>> browsingEvent =
-            std::make_shared < std::vector < Qustodio::BrowsingEvent >> (
-                    std::vector< Qustodio::BrowsingEvent >() ); //< The vector of #BrowsingEvent
+    IngestionOrder order = IngestionOrder::Input;          //< How the shards are published
+    std::atomic< std::uint64_t > nextShard { 0 };           //< Sequence number of the next shard
+    std::uint64_t nextPublished = 0;                       //< Sequence number the #EventStore is waiting for
+    std::map< std::uint64_t, Qustodio::EventStore > pendingShards; //< Shards finished ahead of their turn
+    std::vector< unsigned > segmentLevels;                 //< Merge level of every segment of #published
+    RetentionPolicy retentionPolicy;                       //< See #setRetention
+    std::vector< std::shared_ptr< Qustodio::EventStore >> recycledSegments; //< Cleared evicted segments
+    std::vector< Qustodio::EventVersion::Segment > evictedSegments; //< Evicted segments a reader still holds
+    std::atomic< std::uint64_t > recycledShards { 0 };     //< See #RecycledShards
+    std::weak_ptr< const Qustodio::EventStore > mergedEvents; //< The last merge of #Events with a #RetentionPolicy
+    std::uint64_t mergedVersion = 0;                       //< The version #mergedEvents was merged from
+
+    std::shared_ptr< const Qustodio::EventVersion > published =
+            std::make_shared< const Qustodio::EventVersion >(); //< The current version, read and written atomically
+
+    std::vector< std::shared_ptr< Qustodio::MappedFile>> mappedFiles; //< The mappings #mappedEvents point into
+
+    std::shared_ptr < const std::vector< Qustodio::BrowsingEventView>> mappedEvents =
+            std::make_shared < const std::vector < Qustodio::BrowsingEventView >> (); //< The vector of #BrowsingEventView, read and written atomically
   };
 
 } // namespace Qustodio
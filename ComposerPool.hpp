@@ -29,7 +29,6 @@
 #define COMPOSERPOOL_HPP
 
 #include <vector>
-#include <queue>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -40,6 +39,17 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cassert>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <ostream>
 
 namespace Qustodio
 {
@@ -50,31 +60,145 @@ namespace Qustodio
  * @date 23/12/2018
  * @brief Basic thread pool to handle filters concurrently
  * 
+ * By default each worker keeps a deque of the tasks it enqueues itself and
+ * idle workers steal from the others, so only external producers go through
+ * the shared queue and its queue_mutex.
+ *
+ * The queues are rings of reusable pool_task slots and small callables are
+ * stored inline, so post() does not allocate once the rings have grown.
+ *
+ * Every worker counts what it runs and steals, and the pipeline stages it
+ * records, in its own slot, and the producers count the time they block on
+ * the queue limit; snapshot() adds them up. The wait and run time histograms of the tasks cost two clock
+ * reads per task and are only kept after set_timing(true).
+ *
  * @see https://github.com/log4cplus/ThreadPool/blob/master/ThreadPool.h
  */
   class ComposerPool
   {
     public:
+    // how the tasks reach the workers
+    enum class scheduling
+    {
+        // every task goes through the shared queue
+        shared_queue,
+        // tasks enqueued by a worker stay in its own deque, idle workers
+        // steal from the others and the shared queue only injects the
+        // tasks of external producers
+        work_stealing
+    };
+
     explicit ComposerPool(std::size_t threads
-        = (std::max)(2u, std::thread::hardware_concurrency()));
+        = (std::max)(2u, std::thread::hardware_concurrency()),
+        scheduling mode = scheduling::work_stealing);
+    template<class T> class bulk_future;
+
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args)
         -> std::future<typename std::result_of<F(Args...)>::type>;
+    // fire and forget: no future, and no allocation when f fits in the
+    // inline buffer of a task
+    template<class F>
+    void post(F&& f);
+    // run f(i) for every i in [begin, end), handing out chunks of at least
+    // grain indexes; the handle holds the number of indexes run
+    template<class F>
+    bulk_future<std::size_t> parallel_for(std::size_t begin, std::size_t end,
+        std::size_t grain, F&& f);
+    // run partial = chunk(first, last) over chunks of [begin, end) and fold
+    // the partials into identity with reduce
+    template<class T, class Chunk, class Reduce>
+    bulk_future<T> parallel_reduce(std::size_t begin, std::size_t end,
+        std::size_t grain, T identity, Chunk&& chunk, Reduce&& reduce);
+    // run chunk(first, last) over chunks of [begin, end); the handle holds
+    // the number of indexes run
+    template<class F>
+    bulk_future<std::size_t> parallel_for_chunks(std::size_t begin,
+        std::size_t end, std::size_t grain, F&& f);
+    // one value per worker plus one for the other threads, see worker_local
+    template<class T> class worker_local;
+    // number of the worker running the current thread, npos on any thread
+    // that is not a worker of this pool
+    std::size_t worker_slot() const;
+    static const std::size_t npos = ~std::size_t(0);
     void wait_until_empty();
     void wait_until_nothing_in_flight();
     void set_queue_size_limit(std::size_t limit);
     void set_pool_size(std::size_t limit);
     ~ComposerPool ();
 
+    // durations in power of two buckets of nanoseconds
+    struct latency_histogram;
+    struct stage_statistics;
+    struct statistics;
+    class stage_timer;
+
+    // the counters of the pool added up at the time of the call
+    statistics snapshot();
+    // keep the wait and run time histograms of the tasks
+    void set_timing(bool enabled);
+    // append a line with the snapshot to file every period, until a zero
+    // period or the destruction of the pool
+    void dump_statistics(const std::string & file,
+        std::chrono::milliseconds period);
+    // add items and bytes processed in some nanoseconds by a pipeline stage,
+    // up to max_stages stage names
+    void record_stage(const char * stage, std::uint64_t items,
+        std::uint64_t bytes, std::uint64_t nanoseconds);
+    static const std::size_t max_stages = 16;
+    static void write_statistics(std::ostream & out,
+        const statistics & values);
+
     private:
+    class pool_task;
+    class task_ring;
+
+    // per worker deque, the owner pops from the back, thieves from the front
+    struct worker_queue;
+
+    // the pool and deque of the worker running on the current thread
+    struct worker_identity
+    {
+        const ComposerPool * pool;
+        worker_queue * queue;
+        std::size_t number;
+    };
+
+    static worker_identity & current_worker ();
+
+    // counters of a single worker, only the worker writes them
+    struct worker_counters;
+
+    static std::int64_t now_nanoseconds ();
+    void stop_dump ();
+    // slot of the stage in worker_counters, npos once max_stages are taken
+    std::size_t stage_index (const char * stage);
+
     void emplace_back_worker (std::size_t worker_number);
+    void push_task (pool_task && task);
+    bool pop_local (worker_queue & queue, pool_task & task);
+    bool steal (std::size_t worker_number, pool_task & task);
+    void flush_local (worker_queue & queue);
+
+    // most tasks a worker moves from the shared queue to its deque at once
+    static const std::size_t max_batch_size = 32;
 
     // need to keep track of threads so we can join them
     std::vector< std::thread > workers;
     // target pool size
     std::size_t pool_size;
+    // scheduling policy
+    scheduling mode;
     // the task queue
-    std::queue< std::function<void()> > tasks;
+    std::unique_ptr< task_ring > tasks;
+    // the deques of the workers, only grows and only under queue_mutex
+    std::vector< std::unique_ptr< worker_queue > > local_queues;
+    // tasks taken by a thief on top of the one it runs, only under queue_mutex
+    std::unique_ptr< task_ring > loot;
+    // tasks waiting in the worker deques
+    std::atomic<std::size_t> local_pending;
+    // workers sleeping on condition_consumers
+    std::atomic<std::size_t> idle_workers;
     // queue length limit
     std::size_t max_queue_size = 100000;
     // stop signal
@@ -89,6 +213,29 @@ namespace Qustodio
     std::condition_variable in_flight_condition;
     std::atomic<std::size_t> in_flight;
 
+    // time the tasks from their submission, see set_timing
+    std::atomic<bool> timing;
+    // tasks pushed to the shared queue, only under queue_mutex
+    std::uint64_t shared_submitted = 0;
+    // deepest shared queue seen, only under queue_mutex
+    std::size_t max_queue_depth = 0;
+    // producers blocked on max_queue_size, only under queue_mutex
+    std::uint64_t producer_blocks = 0;
+    std::uint64_t producer_block_nanoseconds = 0;
+
+    // names of the pipeline stages of record_stage, each claimed once
+    std::atomic<const char *> stage_names[max_stages];
+    // stage counters of the threads that are not workers, shared by them
+    std::unique_ptr< worker_counters > outside_counters;
+
+    // the thread of dump_statistics
+    std::mutex dump_mutex;
+    std::condition_variable dump_condition;
+    std::thread dump_thread;
+    bool dump_stop = false;
+
+    template<class T> struct bulk_state;
+
     struct handle_in_flight_decrement
     {
         ComposerPool & tp;
@@ -112,14 +259,651 @@ namespace Qustodio
     };
 };
 
+/*!
+ * @brief Move-only callable queued by ComposerPool
+ *
+ * Callables up to inline_size bytes that can be moved without throwing are
+ * stored in place, the others are moved to the heap.
+ */
+  class ComposerPool::pool_task
+  {
+    public:
+    pool_task () noexcept
+            : operations( nullptr )
+    { }
+
+    template < class F, class = typename std::enable_if<
+            !std::is_same< typename std::decay< F >::type, pool_task >::value >::type >
+    pool_task ( F &&f )
+            : operations( nullptr )
+    {
+      typedef typename std::decay< F >::type function_type;
+      store( std::forward< F >( f ), std::integral_constant< bool, fits_inline< function_type >::value >() );
+    }
+
+    pool_task ( pool_task &&other ) noexcept
+            : submitted( other.submitted ), operations( other.operations )
+    {
+      if ( operations )
+        operations->relocate( & storage, & other.storage );
+      other.operations = nullptr;
+    }
+
+    pool_task & operator= ( pool_task &&other ) noexcept
+    {
+      if ( this != & other )
+      {
+        reset();
+        submitted = other.submitted;
+        operations = other.operations;
+        if ( operations )
+          operations->relocate( & storage, & other.storage );
+        other.operations = nullptr;
+      }
+      return * this;
+    }
+
+    pool_task ( const pool_task & ) = delete;
+    pool_task & operator= ( const pool_task & ) = delete;
+
+    ~pool_task ()
+    {
+      reset();
+    }
+
+    explicit operator bool () const noexcept
+    {
+      return nullptr != operations;
+    }
+
+    void operator() ()
+    {
+      operations->invoke( & storage );
+    }
+
+    // destroy the callable, leaving an empty task
+    void reset () noexcept
+    {
+      if ( operations )
+      {
+        operations->destroy( & storage );
+        operations = nullptr;
+      }
+    }
+
+    // now_nanoseconds() at the submission, zero when the pool is not timing
+    std::int64_t submitted = 0;
+
+    private:
+    static const std::size_t inline_size = 6 * sizeof( void * );
+
+    typedef std::aligned_storage< inline_size, alignof( std::max_align_t ) >::type storage_type;
+
+    // type erased operations on the stored callable
+    struct operation_table
+    {
+      void ( * invoke ) ( void * );
+      // move the callable from the second storage to the first one and destroy the moved-from one
+      void ( * relocate ) ( void *, void * );
+      void ( * destroy ) ( void * );
+    };
+
+    template < class F >
+    struct fits_inline
+            : std::integral_constant< bool, sizeof( F ) <= inline_size
+                                            && alignof( std::max_align_t ) % alignof( F ) == 0
+                                            && std::is_nothrow_move_constructible< F >::value >
+    { };
+
+    template < class F >
+    struct inline_operations
+    {
+      static void invoke ( void *storage )
+      {
+        ( * static_cast< F * >( storage ) )();
+      }
+
+      static void relocate ( void *to, void *from )
+      {
+        F * const function = static_cast< F * >( from );
+        ::new( to ) F( std::move( * function ) );
+        function->~F();
+      }
+
+      static void destroy ( void *storage )
+      {
+        static_cast< F * >( storage )->~F();
+      }
+
+      static const operation_table table;
+    };
+
+    template < class F >
+    struct heap_operations
+    {
+      static void invoke ( void *storage )
+      {
+        ( ** static_cast< F ** >( storage ) )();
+      }
+
+      static void relocate ( void *to, void *from )
+      {
+        ::new( to ) F *( * static_cast< F ** >( from ) );
+      }
+
+      static void destroy ( void *storage )
+      {
+        delete * static_cast< F ** >( storage );
+      }
+
+      static const operation_table table;
+    };
+
+    template < class F >
+    void store ( F &&f, std::true_type )
+    {
+      typedef typename std::decay< F >::type function_type;
+      ::new( & storage ) function_type( std::forward< F >( f ) );
+      operations = & inline_operations< function_type >::table;
+    }
+
+    template < class F >
+    void store ( F &&f, std::false_type )
+    {
+      typedef typename std::decay< F >::type function_type;
+      ::new( & storage ) function_type *( new function_type( std::forward< F >( f ) ) );
+      operations = & heap_operations< function_type >::table;
+    }
+
+    const operation_table * operations;
+    storage_type storage;
+  };
+
+  template < class F >
+  const ComposerPool::pool_task::operation_table ComposerPool::pool_task::inline_operations< F >::table = {
+          & ComposerPool::pool_task::inline_operations< F >::invoke,
+          & ComposerPool::pool_task::inline_operations< F >::relocate,
+          & ComposerPool::pool_task::inline_operations< F >::destroy
+  };
+
+  template < class F >
+  const ComposerPool::pool_task::operation_table ComposerPool::pool_task::heap_operations< F >::table = {
+          & ComposerPool::pool_task::heap_operations< F >::invoke,
+          & ComposerPool::pool_task::heap_operations< F >::relocate,
+          & ComposerPool::pool_task::heap_operations< F >::destroy
+  };
+
+/*!
+ * @brief Double ended queue of tasks over a power of two ring of slots
+ *
+ * The slots are reused as the tasks come and go and only grow when the ring
+ * is full, so a queue in steady state does not allocate.
+ */
+  class ComposerPool::task_ring
+  {
+    public:
+    bool empty () const
+    {
+      return 0 == count;
+    }
+
+    std::size_t size () const
+    {
+      return count;
+    }
+
+    pool_task & front ()
+    {
+      return slots[head];
+    }
+
+    pool_task & back ()
+    {
+      return slots[( head + count - 1 ) & ( slots.size() - 1 )];
+    }
+
+    void push_back ( pool_task &&task )
+    {
+      grow_if_full();
+      slots[( head + count ) & ( slots.size() - 1 )] = std::move( task );
+      ++count;
+    }
+
+    void push_front ( pool_task &&task )
+    {
+      grow_if_full();
+      head = ( head + slots.size() - 1 ) & ( slots.size() - 1 );
+      slots[head] = std::move( task );
+      ++count;
+    }
+
+    void pop_front ()
+    {
+      slots[head].reset();
+      head = ( head + 1 ) & ( slots.size() - 1 );
+      --count;
+    }
+
+    void pop_back ()
+    {
+      back().reset();
+      --count;
+    }
+
+    private:
+    void grow_if_full ()
+    {
+      if ( count < slots.size() )
+        return;
+
+      std::vector< pool_task > grown( ( std::max )( std::size_t( 16 ), 2 * slots.size() ) );
+      for ( std::size_t i = 0; i != count; ++i )
+        grown[i] = std::move( slots[( head + i ) & ( slots.size() - 1 )] );
+      slots.swap( grown );
+      head = 0;
+    }
+
+    std::vector< pool_task > slots;
+    std::size_t head = 0;
+    std::size_t count = 0;
+  };
+
+/*!
+ * @brief Histogram of durations in power of two buckets of nanoseconds
+ *
+ * Bucket b counts the durations in [2^(b-1), 2^b) nanoseconds, so the
+ * quantiles are the upper bound of their bucket, within a factor of two.
+ */
+  struct ComposerPool::latency_histogram
+  {
+    static const std::size_t bucket_count = 48;
+
+    std::uint64_t buckets[bucket_count];
+    std::uint64_t count;
+    std::uint64_t total_nanoseconds;
+
+    latency_histogram ()
+            : buckets(), count( 0 ), total_nanoseconds( 0 )
+    { }
+
+    static std::size_t bucket ( std::uint64_t nanoseconds )
+    {
+      if ( 0 == nanoseconds )
+        return 0;
+#if defined( __GNUC__ )
+      std::size_t const index = 64 - static_cast< std::size_t >( __builtin_clzll( nanoseconds ) );
+#else
+      std::size_t index = 0;
+      for ( ; nanoseconds != 0; nanoseconds >>= 1 )
+        ++index;
+#endif
+      return ( std::min )( index, bucket_count - 1 );
+    }
+
+    // upper bound in nanoseconds of the fraction quantile
+    double quantile ( double fraction ) const
+    {
+      if ( 0 == count )
+        return 0.0;
+      std::uint64_t const rank = static_cast< std::uint64_t >( fraction * static_cast< double >( count - 1 ) );
+      std::uint64_t seen = 0;
+      for ( std::size_t b = 0; b != bucket_count; ++b )
+      {
+        seen += buckets[b];
+        if ( seen > rank )
+          return b == 0 ? 0.0 : static_cast< double >( std::uint64_t( 1 ) << b );
+      }
+      return static_cast< double >( std::uint64_t( 1 ) << ( bucket_count - 1 ) );
+    }
+
+    double mean () const
+    {
+      return 0 == count ? 0.0 : static_cast< double >( total_nanoseconds ) / static_cast< double >( count );
+    }
+  };
+
+/*!
+ * @brief Work done by a pipeline stage, see ComposerPool::record_stage
+ *
+ * The nanoseconds add up the time of every thread in the stage, so
+ * items / seconds is the rate of a single busy thread.
+ */
+  struct ComposerPool::stage_statistics
+  {
+    std::string name;
+    std::uint64_t calls = 0;
+    std::uint64_t items = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t nanoseconds = 0;
+  };
+
+/*!
+ * @brief The counters of a ComposerPool added up by ComposerPool::snapshot
+ */
+  struct ComposerPool::statistics
+  {
+    std::size_t workers = 0;
+    // tasks waiting in the shared queue and in the worker deques
+    std::size_t queue_depth = 0;
+    std::size_t local_depth = 0;
+    std::size_t max_queue_depth = 0;
+    std::size_t queue_limit = 0;
+    std::size_t in_flight = 0;
+    std::uint64_t submitted = 0;
+    std::uint64_t executed = 0;
+    // successful steals and the tasks they took
+    std::uint64_t steals = 0;
+    std::uint64_t stolen_tasks = 0;
+    // producers that found the shared queue full and the time they waited
+    std::uint64_t producer_blocks = 0;
+    std::uint64_t producer_block_nanoseconds = 0;
+    // from the submission to the start of a task, and its run, with timing on
+    latency_histogram wait_time;
+    latency_histogram run_time;
+    // executed tasks of every worker slot
+    std::vector< std::uint64_t > tasks_per_worker;
+    std::vector< stage_statistics > stages;
+  };
+
+/*!
+ * @brief Records the lifetime of a scope as one call of a pipeline stage
+ */
+  class ComposerPool::stage_timer
+  {
+    public:
+    stage_timer ( ComposerPool & pool, const char * stage )
+            : pool( pool ), stage( stage ), start( now_nanoseconds() )
+    { }
+
+    stage_timer ( const stage_timer & ) = delete;
+    stage_timer & operator= ( const stage_timer & ) = delete;
+
+    ~stage_timer ()
+    {
+      pool.record_stage( stage, items, bytes, static_cast< std::uint64_t >( now_nanoseconds() - start ) );
+    }
+
+    void add ( std::uint64_t more_items, std::uint64_t more_bytes = 0 )
+    {
+      items += more_items;
+      bytes += more_bytes;
+    }
+
+    private:
+    ComposerPool & pool;
+    const char * stage;
+    std::int64_t start;
+    std::uint64_t items = 0;
+    std::uint64_t bytes = 0;
+  };
+
+/*!
+ * @brief One value per worker of a ComposerPool, plus one for the threads
+ * that are not workers, each on its own cache lines
+ *
+ * The tasks update local() without any lock or atomic, and for_each() folds
+ * the values once nothing runs. The slots are counted when it is built, so
+ * the pool must not grow while it is in use, and the threads that are not
+ * workers share their slot, so only one of them may use it at a time, such
+ * as the one waiting on a bulk_future.
+ */
+  template < class T >
+  class ComposerPool::worker_local
+  {
+    public:
+    explicit worker_local ( ComposerPool & pool, const T & initial = T() )
+            : pool( pool )
+    {
+      std::size_t workers;
+      {
+        std::unique_lock <std::mutex> lock( pool.queue_mutex );
+        workers = pool.local_queues.size();
+      }
+      slots.reserve( workers + 1 );
+      for ( std::size_t i = 0; i != workers + 1; ++i )
+        slots.emplace_back( new slot( initial ) );
+    }
+
+    T & local ()
+    {
+      std::size_t const worker = pool.worker_slot();
+      return slots[worker < slots.size() - 1 ? worker : slots.size() - 1]->value;
+    }
+
+    template < class F >
+    void for_each ( F && f )
+    {
+      for ( auto &&each: slots )
+        f( each->value );
+    }
+
+    private:
+    struct slot
+    {
+      explicit slot ( const T & initial )
+              : value( initial )
+      { }
+
+      char before[64];
+      T value;
+      char after[64];
+    };
+
+    ComposerPool & pool;
+    std::vector< std::unique_ptr< slot > > slots;
+  };
+
+  struct ComposerPool::worker_counters
+  {
+    std::atomic< std::uint64_t > executed;
+    std::atomic< std::uint64_t > submitted;
+    std::atomic< std::uint64_t > steals;
+    std::atomic< std::uint64_t > stolen_tasks;
+    std::atomic< std::uint64_t > wait_buckets[latency_histogram::bucket_count];
+    std::atomic< std::uint64_t > run_buckets[latency_histogram::bucket_count];
+    std::atomic< std::uint64_t > wait_nanoseconds;
+    std::atomic< std::uint64_t > run_nanoseconds;
+    // the stages of ComposerPool::record_stage, by ComposerPool::stage_index
+    std::atomic< std::uint64_t > stage_calls[max_stages];
+    std::atomic< std::uint64_t > stage_items[max_stages];
+    std::atomic< std::uint64_t > stage_bytes[max_stages];
+    std::atomic< std::uint64_t > stage_nanoseconds[max_stages];
+
+    worker_counters ()
+    {
+      executed.store( 0 );
+      submitted.store( 0 );
+      steals.store( 0 );
+      stolen_tasks.store( 0 );
+      for ( std::size_t b = 0; b != latency_histogram::bucket_count; ++b )
+      {
+        wait_buckets[b].store( 0 );
+        run_buckets[b].store( 0 );
+      }
+      wait_nanoseconds.store( 0 );
+      run_nanoseconds.store( 0 );
+      for ( std::size_t s = 0; s != max_stages; ++s )
+      {
+        stage_calls[s].store( 0 );
+        stage_items[s].store( 0 );
+        stage_bytes[s].store( 0 );
+        stage_nanoseconds[s].store( 0 );
+      }
+    }
+
+    // a single writer needs no read-modify-write
+    static void add ( std::atomic< std::uint64_t > & counter, std::uint64_t value )
+    {
+      counter.store( counter.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+    }
+
+    void time_task ( std::int64_t submitted_at, std::int64_t started_at, std::int64_t finished_at )
+    {
+      std::uint64_t const wait = static_cast< std::uint64_t >( started_at - submitted_at );
+      std::uint64_t const run = static_cast< std::uint64_t >( finished_at - started_at );
+      add( wait_buckets[latency_histogram::bucket( wait )], 1 );
+      add( run_buckets[latency_histogram::bucket( run )], 1 );
+      add( wait_nanoseconds, wait );
+      add( run_nanoseconds, run );
+    }
+  };
+
+  struct ComposerPool::worker_queue
+  {
+    std::mutex mutex;
+    task_ring tasks;
+    // keeps the counters the owner writes off the lines the thieves lock
+    char padding[64];
+    worker_counters counters;
+  };
+
+/*!
+ * @brief Completion handle of ComposerPool::parallel_for and ComposerPool::parallel_reduce
+ *
+ * Waiting on it runs the chunks nobody has claimed yet on the waiting thread,
+ * so it is safe to wait from inside a task of the same pool.
+ */
+  template < class T >
+  class ComposerPool::bulk_future
+  {
+    public:
+    explicit bulk_future ( std::shared_ptr< bulk_state< T > > state )
+            : state( std::move( state ) )
+    { }
+
+    // true once every chunk has run
+    bool ready () const;
+    // help with the pending chunks and wait for the others
+    void wait () const;
+    // wait and return the reduction, rethrowing the first exception of a chunk
+    T get () const;
+
+    private:
+    std::shared_ptr< bulk_state< T > > state;
+  };
+
+// the shared state of a bulk submission: the workers claim chunks from
+// next until the range is exhausted, each one folding its own partial and
+// merging it once at the end
+  template < class T >
+  struct ComposerPool::bulk_state
+  {
+    std::size_t end;
+    std::size_t grain;
+    std::size_t workers;
+    std::size_t total;
+    std::atomic< std::size_t > next;
+    std::function< T ( std::size_t, std::size_t ) > chunk;
+    std::function< T ( T, T ) > reduce;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t processed = 0;
+    T value;
+    std::exception_ptr error;
+    std::atomic< bool > failed;
+
+    // guided self-scheduling: big chunks first, grain sized ones at the end
+    bool claim ( std::size_t &first, std::size_t &last )
+    {
+      first = next.load( std::memory_order_relaxed );
+      do
+      {
+        if ( first >= end )
+          return false;
+        std::size_t const size = ( std::max )( grain, ( end - first ) / ( 2 * workers ) );
+        last = ( std::min )( end, first + size );
+      } while ( !next.compare_exchange_weak( first, last, std::memory_order_relaxed ) );
+      return true;
+    }
+
+    void run ()
+    {
+      std::size_t first = 0;
+      std::size_t last = 0;
+      std::size_t count = 0;
+      bool any = false;
+      T partial = T();
+      std::exception_ptr chunk_error;
+
+      while ( claim( first, last ) )
+      {
+        count += last - first;
+        if ( failed.load( std::memory_order_relaxed ) )
+          continue;
+        try
+        {
+          T result = chunk( first, last );
+          partial = any ? reduce( std::move( partial ), std::move( result ) ) : std::move( result );
+          any = true;
+        }
+        catch ( ... )
+        {
+          chunk_error = std::current_exception();
+          failed.store( true, std::memory_order_relaxed );
+        }
+      }
+
+      if ( 0 == count )
+        return;
+
+      std::unique_lock< std::mutex > lock( mutex );
+      if ( any )
+        value = reduce( std::move( value ), std::move( partial ) );
+      if ( chunk_error && !error )
+        error = chunk_error;
+      processed += count;
+      if ( processed == total )
+        done.notify_all();
+    }
+  };
+
+  template < class T >
+  inline bool ComposerPool::bulk_future< T >::ready () const
+  {
+    std::unique_lock< std::mutex > lock( state->mutex );
+    return state->processed == state->total;
+  }
+
+  template < class T >
+  inline void ComposerPool::bulk_future< T >::wait () const
+  {
+    state->run();
+    std::unique_lock< std::mutex > lock( state->mutex );
+    state->done.wait( lock, [ this ] { return state->processed == state->total; } );
+  }
+
+  template < class T >
+  inline T ComposerPool::bulk_future< T >::get () const
+  {
+    wait();
+    std::unique_lock< std::mutex > lock( state->mutex );
+    if ( state->error )
+      std::rethrow_exception( state->error );
+    return state->value;
+  }
+
 // the constructor just launches some amount of workers
-  inline ComposerPool::ComposerPool ( std::size_t threads )
-          : pool_size( threads ), in_flight( 0 )
+  inline ComposerPool::ComposerPool ( std::size_t threads, scheduling mode )
+          : pool_size( threads ), mode( mode ), tasks( new task_ring ), loot( new task_ring ),
+            local_pending( 0 ), idle_workers( 0 ), in_flight( 0 ), timing( false ),
+            outside_counters( new worker_counters )
   {
+    for ( std::size_t s = 0; s != max_stages; ++s )
+      stage_names[s].store( nullptr );
+
+    // the workers already running look at local_queues while the others are created
+    std::unique_lock <std::mutex> lock( queue_mutex );
     for ( std::size_t i = 0; i != threads; ++i )
       emplace_back_worker( i );
   }
 
+  inline ComposerPool::worker_identity & ComposerPool::current_worker ()
+  {
+    static thread_local worker_identity identity = { nullptr, nullptr, npos };
+    return identity;
+  }
+
 // add new work item to the pool
   template < class F, class... Args >
   auto ComposerPool::enqueue ( F &&f, Args &&... args ) -> std::future< typename std::result_of< F( Args... ) >::type >
@@ -132,33 +916,194 @@ namespace Qustodio
 
     std::future <return_type> res = task->get_future();
 
+    push_task( pool_task( [ task ] () { ( * task )(); } ) );
+
+    return res;
+  }
+
+  template < class F >
+  inline void ComposerPool::post ( F &&f )
+  {
+    push_task( pool_task( std::forward< F >( f ) ) );
+  }
+
+  template < class F >
+  inline ComposerPool::bulk_future< std::size_t > ComposerPool::parallel_for ( std::size_t begin, std::size_t end,
+                                                                            std::size_t grain, F &&f )
+  {
+    typedef typename std::decay< F >::type function_type;
+    auto function = std::make_shared< function_type >( std::forward< F >( f ) );
+
+    return parallel_reduce( begin, end, grain, std::size_t( 0 ),
+                            [ function ] ( std::size_t first, std::size_t last )
+                            {
+                              for ( std::size_t i = first; i != last; ++i )
+                                ( * function )( i );
+                              return last - first;
+                            },
+                            [] ( std::size_t lhs, std::size_t rhs ) { return lhs + rhs; } );
+  }
+
+  template < class T, class Chunk, class Reduce >
+  inline ComposerPool::bulk_future< T > ComposerPool::parallel_reduce ( std::size_t begin, std::size_t end,
+                                                                       std::size_t grain, T identity,
+                                                                       Chunk &&chunk, Reduce &&reduce )
+  {
+    auto state = std::make_shared< bulk_state< T > >();
+    state->end = end;
+    state->grain = ( std::max )( grain, std::size_t( 1 ) );
+    state->total = end > begin ? end - begin : 0;
+    state->next.store( begin );
+    state->chunk = std::forward< Chunk >( chunk );
+    state->reduce = std::forward< Reduce >( reduce );
+    state->value = std::move( identity );
+    state->failed.store( false );
+
+    std::size_t workers;
+    {
+      std::unique_lock <std::mutex> lock( queue_mutex );
+      workers = ( std::max )( pool_size, std::size_t( 1 ) );
+    }
+    state->workers = workers;
+
+    // one task per worker at most, they keep claiming chunks until the
+    // range is exhausted
+    std::size_t const chunks = ( state->total + state->grain - 1 ) / state->grain;
+    std::size_t const tasks_to_push = ( std::min )( workers, chunks );
+    for ( std::size_t i = 0; i != tasks_to_push; ++i )
+      push_task( pool_task( [ state ] () { state->run(); } ) );
+
+    return bulk_future< T >( state );
+  }
+
+// route a task to the deque of the current worker or to the shared queue
+  inline void ComposerPool::push_task ( pool_task &&task )
+  {
+    if ( timing.load( std::memory_order_relaxed ) )
+      task.submitted = now_nanoseconds();
+
+    worker_identity &identity = current_worker();
+    if ( scheduling::work_stealing == mode && this == identity.pool )
+    {
+      worker_counters::add( identity.queue->counters.submitted, 1 );
+      // a worker never blocks on its own deque, that could deadlock the pool
+      std::atomic_fetch_add_explicit( & in_flight,
+                                      std::size_t( 1 ),
+                                      std::memory_order_relaxed );
+      {
+        std::unique_lock <std::mutex> lock( identity.queue->mutex );
+        identity.queue->tasks.push_back( std::move( task ) );
+      }
+      local_pending.fetch_add( 1 );
+      if ( idle_workers.load() > 0 )
+      {
+        std::unique_lock <std::mutex> lock( queue_mutex );
+        condition_consumers.notify_one();
+      }
+      return;
+    }
+
     std::unique_lock <std::mutex> lock( queue_mutex );
-    if ( tasks.size() >= max_queue_size )
+    if ( tasks->size() >= max_queue_size )
+    {
+      std::int64_t const blocked = now_nanoseconds();
       // wait for the queue to empty or be stopped
       condition_producers.wait( lock,
                                 [ this ]
                                 {
-                                  return tasks.size() < max_queue_size
+                                  return tasks->size() < max_queue_size
                                          || stop;
                                 } );
+      ++producer_blocks;
+      producer_block_nanoseconds += static_cast< std::uint64_t >( now_nanoseconds() - blocked );
+    }
 
     // don't allow enqueueing after stopping the pool
     if ( stop )
       throw std::runtime_error( "enqueue on stopped ComposerPool" );
 
-    tasks.emplace( [ task ] () { ( * task )(); } );
+    tasks->push_back( std::move( task ) );
+    ++shared_submitted;
+    max_queue_depth = ( std::max )( max_queue_depth, tasks->size() );
     std::atomic_fetch_add_explicit( & in_flight,
                                     std::size_t( 1 ),
                                     std::memory_order_relaxed );
     condition_consumers.notify_one();
+  }
 
-    return res;
+  inline bool ComposerPool::pop_local ( worker_queue &queue, pool_task &task )
+  {
+    std::unique_lock <std::mutex> lock( queue.mutex );
+    if ( queue.tasks.empty() )
+      return false;
+
+    task = std::move( queue.tasks.back() );
+    queue.tasks.pop_back();
+    local_pending.fetch_sub( 1 );
+    return true;
+  }
+
+// called with queue_mutex held, which keeps local_queues stable and
+// serializes the thieves
+  inline bool ComposerPool::steal ( std::size_t worker_number, pool_task &task )
+  {
+    std::size_t const count = local_queues.size();
+    for ( std::size_t offset = 1; offset <= count; ++offset )
+    {
+      worker_queue &victim = * local_queues[( worker_number + offset ) % count];
+      if ( & victim == local_queues[worker_number].get() )
+        continue;
+
+      // take the oldest task and half of the rest to amortize the steal
+      {
+        std::unique_lock <std::mutex> lock( victim.mutex );
+        if ( victim.tasks.empty() )
+          continue;
+
+        task = std::move( victim.tasks.front() );
+        victim.tasks.pop_front();
+        for ( std::size_t taken = victim.tasks.size() / 2; taken != 0; --taken )
+        {
+          loot->push_back( std::move( victim.tasks.back() ) );
+          victim.tasks.pop_back();
+        }
+      }
+      worker_counters &counters = local_queues[worker_number]->counters;
+      worker_counters::add( counters.steals, 1 );
+      worker_counters::add( counters.stolen_tasks, 1 + loot->size() );
+      // never hold two deques at once
+      if ( !loot->empty() )
+      {
+        worker_queue &own = * local_queues[worker_number];
+        std::unique_lock <std::mutex> lock( own.mutex );
+        for ( ; !loot->empty(); loot->pop_front() )
+          own.tasks.push_front( std::move( loot->front() ) );
+      }
+      local_pending.fetch_sub( 1 );
+      return true;
+    }
+    return false;
+  }
+
+// called with queue_mutex held by a worker about to exit
+  inline void ComposerPool::flush_local ( worker_queue &queue )
+  {
+    std::unique_lock <std::mutex> lock( queue.mutex );
+    while ( !queue.tasks.empty() )
+    {
+      tasks->push_back( std::move( queue.tasks.front() ) );
+      queue.tasks.pop_front();
+      local_pending.fetch_sub( 1 );
+    }
   }
 
 
 // the destructor joins all threads
   inline ComposerPool::~ComposerPool ()
   {
+    // the dump thread takes snapshots, which lock queue_mutex
+    stop_dump();
+
     std::unique_lock <std::mutex> lock( queue_mutex );
     stop = true;
     condition_consumers.notify_all();
@@ -172,7 +1117,7 @@ namespace Qustodio
   {
     std::unique_lock <std::mutex> lock( this->queue_mutex );
     this->condition_producers.wait( lock,
-                                    [ this ] { return this->tasks.empty(); } );
+                                    [ this ] { return this->tasks->empty(); } );
   }
 
   inline void ComposerPool::wait_until_nothing_in_flight ()
@@ -217,29 +1162,261 @@ namespace Qustodio
       this->condition_consumers.notify_all();
   }
 
+  inline std::int64_t ComposerPool::now_nanoseconds ()
+  {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  inline void ComposerPool::set_timing ( bool enabled )
+  {
+    timing.store( enabled );
+  }
+
+  inline ComposerPool::statistics ComposerPool::snapshot ()
+  {
+    statistics values;
+    {
+      std::unique_lock <std::mutex> lock( queue_mutex );
+      values.workers = workers.size();
+      values.queue_depth = tasks->size();
+      values.max_queue_depth = max_queue_depth;
+      values.queue_limit = max_queue_size;
+      values.submitted = shared_submitted;
+      values.producer_blocks = producer_blocks;
+      values.producer_block_nanoseconds = producer_block_nanoseconds;
+
+      // the slots outlive their workers, so a resized pool keeps its history
+      for ( auto &&queue: local_queues )
+      {
+        const worker_counters &counters = queue->counters;
+        std::uint64_t const executed = counters.executed.load( std::memory_order_relaxed );
+        values.tasks_per_worker.push_back( executed );
+        values.executed += executed;
+        values.submitted += counters.submitted.load( std::memory_order_relaxed );
+        values.steals += counters.steals.load( std::memory_order_relaxed );
+        values.stolen_tasks += counters.stolen_tasks.load( std::memory_order_relaxed );
+        for ( std::size_t b = 0; b != latency_histogram::bucket_count; ++b )
+        {
+          std::uint64_t const waited = counters.wait_buckets[b].load( std::memory_order_relaxed );
+          values.wait_time.buckets[b] += waited;
+          values.wait_time.count += waited;
+          std::uint64_t const ran = counters.run_buckets[b].load( std::memory_order_relaxed );
+          values.run_time.buckets[b] += ran;
+          values.run_time.count += ran;
+        }
+        values.wait_time.total_nanoseconds += counters.wait_nanoseconds.load( std::memory_order_relaxed );
+        values.run_time.total_nanoseconds += counters.run_nanoseconds.load( std::memory_order_relaxed );
+      }
+    }
+    values.local_depth = local_pending.load();
+    values.in_flight = in_flight.load();
+
+    for ( std::size_t s = 0; s != max_stages; ++s )
+    {
+      const char * const name = stage_names[s].load( std::memory_order_acquire );
+      if ( nullptr == name )
+        break;
+
+      stage_statistics stage;
+      stage.name = name;
+      auto add_up = [ &stage, s ] ( const worker_counters &counters )
+      {
+        stage.calls += counters.stage_calls[s].load( std::memory_order_relaxed );
+        stage.items += counters.stage_items[s].load( std::memory_order_relaxed );
+        stage.bytes += counters.stage_bytes[s].load( std::memory_order_relaxed );
+        stage.nanoseconds += counters.stage_nanoseconds[s].load( std::memory_order_relaxed );
+      };
+      {
+        std::unique_lock <std::mutex> lock( queue_mutex );
+        for ( auto &&queue: local_queues )
+          add_up( queue->counters );
+      }
+      add_up( * outside_counters );
+      values.stages.push_back( stage );
+    }
+    return values;
+  }
+
+  inline std::size_t ComposerPool::stage_index ( const char *stage )
+  {
+    // the names never change once claimed, so the lookup takes no lock and
+    // the literal a stage is usually recorded with is found by its address
+    for ( std::size_t s = 0; s != max_stages; ++s )
+    {
+      const char * const name = stage_names[s].load( std::memory_order_acquire );
+      if ( nullptr == name )
+        break;
+      if ( name == stage )
+        return s;
+    }
+    for ( std::size_t s = 0; s != max_stages; ++s )
+    {
+      const char * name = stage_names[s].load( std::memory_order_acquire );
+      if ( nullptr == name && stage_names[s].compare_exchange_strong( name, stage, std::memory_order_acq_rel ) )
+        return s;
+      if ( 0 == std::strcmp( name, stage ) )
+        return s;
+    }
+    return npos;
+  }
+
+  inline void ComposerPool::record_stage ( const char *stage, std::uint64_t items, std::uint64_t bytes,
+                                           std::uint64_t nanoseconds )
+  {
+    std::size_t const s = stage_index( stage );
+    if ( npos == s )
+      return;
+
+    const worker_identity &identity = current_worker();
+    if ( this == identity.pool )
+    {
+      // the slot of this worker, nobody else writes it
+      worker_counters &counters = identity.queue->counters;
+      worker_counters::add( counters.stage_calls[s], 1 );
+      worker_counters::add( counters.stage_items[s], items );
+      worker_counters::add( counters.stage_bytes[s], bytes );
+      worker_counters::add( counters.stage_nanoseconds[s], nanoseconds );
+      return;
+    }
+
+    worker_counters &counters = * outside_counters;
+    counters.stage_calls[s].fetch_add( 1, std::memory_order_relaxed );
+    counters.stage_items[s].fetch_add( items, std::memory_order_relaxed );
+    counters.stage_bytes[s].fetch_add( bytes, std::memory_order_relaxed );
+    counters.stage_nanoseconds[s].fetch_add( nanoseconds, std::memory_order_relaxed );
+  }
+
+  inline void ComposerPool::write_statistics ( std::ostream &out, const statistics &values )
+  {
+    out << "workers=" << values.workers
+        << " queue_depth=" << values.queue_depth
+        << " local_depth=" << values.local_depth
+        << " max_queue_depth=" << values.max_queue_depth
+        << " queue_limit=" << values.queue_limit
+        << " in_flight=" << values.in_flight
+        << " submitted=" << values.submitted
+        << " executed=" << values.executed
+        << " steals=" << values.steals
+        << " stolen_tasks=" << values.stolen_tasks
+        << " producer_blocks=" << values.producer_blocks
+        << " producer_block_ms=" << values.producer_block_nanoseconds / 1e6
+        << " wait_p50_us=" << values.wait_time.quantile( 0.50 ) / 1e3
+        << " wait_p99_us=" << values.wait_time.quantile( 0.99 ) / 1e3
+        << " run_p50_us=" << values.run_time.quantile( 0.50 ) / 1e3
+        << " run_p99_us=" << values.run_time.quantile( 0.99 ) / 1e3
+        << " tasks_per_worker=";
+    for ( std::size_t i = 0; i != values.tasks_per_worker.size(); ++i )
+      out << ( i == 0 ? "" : "," ) << values.tasks_per_worker[i];
+    for ( auto &&stage: values.stages )
+    {
+      double const seconds = static_cast< double >( stage.nanoseconds ) / 1e9;
+      out << " " << stage.name << "_items=" << stage.items
+          << " " << stage.name << "_items_per_s=" << ( seconds > 0 ? static_cast< double >( stage.items ) / seconds : 0 )
+          << " " << stage.name << "_mb_per_s="
+          << ( seconds > 0 ? static_cast< double >( stage.bytes ) / seconds / 1e6 : 0 );
+    }
+    out << '\n';
+  }
+
+  inline void ComposerPool::dump_statistics ( const std::string &file, std::chrono::milliseconds period )
+  {
+    stop_dump();
+    if ( period.count() <= 0 )
+      return;
+
+    dump_thread = std::thread(
+            [ this, file, period ]
+            {
+              std::unique_lock <std::mutex> lock( dump_mutex );
+              while ( !dump_condition.wait_for( lock, period, [ this ] { return dump_stop; } ) )
+              {
+                lock.unlock();
+                std::ofstream out( file, std::ios::app );
+                out << std::chrono::duration_cast< std::chrono::milliseconds >(
+                        std::chrono::system_clock::now().time_since_epoch() ).count() << ' ';
+                write_statistics( out, snapshot() );
+                lock.lock();
+              }
+            } );
+  }
+
+  inline void ComposerPool::stop_dump ()
+  {
+    {
+      std::unique_lock <std::mutex> lock( dump_mutex );
+      dump_stop = true;
+    }
+    dump_condition.notify_all();
+    if ( dump_thread.joinable() )
+      dump_thread.join();
+    dump_stop = false;
+  }
+
+  template < class F >
+  inline ComposerPool::bulk_future< std::size_t > ComposerPool::parallel_for_chunks ( std::size_t begin,
+                                                                                   std::size_t end,
+                                                                                   std::size_t grain, F &&f )
+  {
+    typedef typename std::decay< F >::type function_type;
+    auto function = std::make_shared< function_type >( std::forward< F >( f ) );
+
+    return parallel_reduce( begin, end, grain, std::size_t( 0 ),
+                            [ function ] ( std::size_t first, std::size_t last )
+                            {
+                              ( * function )( first, last );
+                              return last - first;
+                            },
+                            [] ( std::size_t lhs, std::size_t rhs ) { return lhs + rhs; } );
+  }
+
+  inline std::size_t ComposerPool::worker_slot () const
+  {
+    const worker_identity &identity = current_worker();
+    if ( this != identity.pool )
+      return npos;
+    return identity.number;
+  }
+
   inline void ComposerPool::emplace_back_worker ( std::size_t worker_number )
   {
+    // the deques outlive their workers so a resized pool reuses them
+    if ( local_queues.size() <= worker_number )
+      local_queues.emplace_back( new worker_queue );
+    worker_queue * const own = local_queues[worker_number].get();
+
     workers.emplace_back(
-            [ this, worker_number ]
+            [ this, worker_number, own ]
             {
+              current_worker().pool = this;
+              current_worker().queue = own;
+              current_worker().number = worker_number;
+
               for ( ;; )
               {
-                std::function< void () > task;
-                bool notify;
+                pool_task task;
+                bool notify = false;
 
+                if ( scheduling::work_stealing != this->mode || !this->pop_local( * own, task ) )
                 {
                   std::unique_lock <std::mutex> lock( this->queue_mutex );
+                  this->idle_workers.fetch_add( 1 );
                   this->condition_consumers.wait( lock,
                                                   [ this, worker_number ]
                                                   {
-                                                    return this->stop || !this->tasks.empty()
+                                                    return this->stop || !this->tasks->empty()
+                                                           || this->local_pending.load() > 0
                                                            || pool_size < worker_number + 1;
                                                   } );
+                  this->idle_workers.fetch_sub( 1 );
 
                   // deal with downsizing of thread pool or shutdown
-                  if ( ( this->stop && this->tasks.empty() )
+                  if ( ( this->stop && this->tasks->empty() && this->local_pending.load() == 0 )
                        || ( !this->stop && pool_size < worker_number + 1 ) )
                   {
+                    // hand the pending tasks of this worker to the others
+                    this->flush_local( * own );
+
                     std::thread &last_thread = this->workers.back();
                     std::thread::id this_id = std::this_thread::get_id();
                     if ( this_id == last_thread.get_id() )
@@ -252,13 +1429,34 @@ namespace Qustodio
                       return;
                     } else
                       continue;
-                  } else if ( !this->tasks.empty() )
+                  } else if ( !this->tasks->empty() )
                   {
-                    task = std::move( this->tasks.front() );
-                    this->tasks.pop();
-                    notify = this->tasks.size() + 1 == max_queue_size
-                             || this->tasks.empty();
-                  } else
+                    std::size_t const queued = this->tasks->size();
+                    task = std::move( this->tasks->front() );
+                    this->tasks->pop_front();
+
+                    if ( scheduling::work_stealing == this->mode && !this->tasks->empty() )
+                    {
+                      // move a share of the shared queue to the own deque so
+                      // the next tasks don't need queue_mutex
+                      std::size_t const share = ( std::min )( std::size_t( max_batch_size ),
+                                                              this->tasks->size() / ( std::max )( pool_size, std::size_t( 1 ) ) );
+                      if ( share > 0 )
+                      {
+                        std::unique_lock <std::mutex> own_lock( own->mutex );
+                        for ( std::size_t i = 0; i != share; ++i )
+                        {
+                          own->tasks.push_front( std::move( this->tasks->front() ) );
+                          this->tasks->pop_front();
+                        }
+                        this->local_pending.fetch_add( share );
+                        this->condition_consumers.notify_one();
+                      }
+                    }
+
+                    notify = ( queued >= max_queue_size && this->tasks->size() < max_queue_size )
+                             || this->tasks->empty();
+                  } else if ( scheduling::work_stealing != this->mode || !this->steal( worker_number, task ) )
                     continue;
                 }
 
@@ -270,7 +1468,15 @@ namespace Qustodio
                   condition_producers.notify_all();
                 }
 
-                task();
+                if ( 0 != task.submitted )
+                {
+                  std::int64_t const started = now_nanoseconds();
+                  task();
+                  own->counters.time_task( task.submitted, started, now_nanoseconds() );
+                }
+                else
+                  task();
+                worker_counters::add( own->counters.executed, 1 );
               }
             }
     );
@@ -0,0 +1,200 @@
+#include "CompressedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef COMPRESSEDFILE_ZLIB
+#define COMPRESSEDFILE_ZLIB 0
+#endif
+
+#if COMPRESSEDFILE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+  const std::size_t inputSize = 256 << 10; //< Compressed bytes read from the file at once
+
+  /**
+   * @brief Reads up to #size bytes, retrying the reads interrupted by a signal
+   */
+  std::size_t readSome ( int descriptor, char *buffer, std::size_t size )
+  {
+    for ( ;; )
+    {
+      const ssize_t count = ::read( descriptor, buffer, size );
+      if ( count >= 0 )
+        return static_cast< std::size_t >( count );
+      if ( EINTR != errno )
+        throw std::runtime_error( std::string( "CompressedFile: " ) + std::strerror( errno ) );
+    }
+  }
+} // namespace
+
+/**
+ * @brief The state of the decoder of the open file
+ */
+struct Qustodio::CompressedFile::Decoder
+{
+  std::size_t inputFirst = 0; //< First byte of CompressedFile::m_Input not decoded yet
+  std::size_t inputLast = 0;  //< One past the last byte read to CompressedFile::m_Input
+  bool atBoundary = true;     //< True between two gzip members, where the file may end
+#if COMPRESSEDFILE_ZLIB
+  z_stream zlib = z_stream();         //< The gzip decoder
+  bool zlibReady = false;             //< True once #zlib is initialized
+#endif
+
+  ~Decoder ()
+  {
+#if COMPRESSEDFILE_ZLIB
+    if ( this->zlibReady )
+      inflateEnd( & this->zlib );
+#endif
+  }
+};
+
+Qustodio::CompressedFile::CompressedFile () = default;
+
+Qustodio::CompressedFile::~CompressedFile ()
+{
+  this->close();
+}
+
+Qustodio::CompressedFile::Format Qustodio::CompressedFile::detect ( const std::string &fileToRead )
+{
+  // reading the first bytes of a pipe would take them from its reader
+  struct stat status;
+  if ( 0 != ::stat( fileToRead.c_str(), & status ) || !S_ISREG( status.st_mode ) )
+    return Format::Plain;
+
+  const int descriptor = ::open( fileToRead.c_str(), O_RDONLY );
+  if ( descriptor < 0 )
+    return Format::Plain;
+
+  unsigned char magic[4] = {};
+  const ssize_t count = ::read( descriptor, magic, sizeof( magic ) );
+  ::close( descriptor );
+
+  if ( count >= 2 && 0x1f == magic[0] && 0x8b == magic[1] )
+    return Format::Gzip;
+  if ( count >= 4 && 0x28 == magic[0] && 0xb5 == magic[1] && 0x2f == magic[2] && 0xfd == magic[3] )
+    return Format::Zstd;
+  return Format::Plain;
+}
+
+bool Qustodio::CompressedFile::supported ( Format format )
+{
+  switch ( format )
+  {
+    case Format::Gzip:
+      return COMPRESSEDFILE_ZLIB;
+    case Format::Zstd:
+      return false;
+    default:
+      return true;
+  }
+}
+
+bool Qustodio::CompressedFile::open ( const std::string &fileToRead )
+{
+  this->close();
+
+  const Format format = detect( fileToRead );
+  if ( !supported( format ) )
+    return false;
+
+  std::unique_ptr< Decoder > decoder( new Decoder );
+#if COMPRESSEDFILE_ZLIB
+  // 32 recognizes the gzip header
+  if ( Format::Gzip == format )
+  {
+    if ( Z_OK != inflateInit2( & decoder->zlib, 15 + 32 ) )
+      return false;
+    decoder->zlibReady = true;
+  }
+#endif
+
+  const int descriptor = ::open( fileToRead.c_str(), O_RDONLY );
+  if ( descriptor < 0 )
+    return false;
+
+  // the decoders read the file front to back once
+  ::posix_fadvise( descriptor, 0, 0, POSIX_FADV_SEQUENTIAL );
+  this->m_Descriptor = descriptor;
+  this->m_Format = format;
+  this->m_Decoder = std::move( decoder );
+  if ( Format::Plain != format )
+    this->m_Input.resize( inputSize );
+  return true;
+}
+
+void Qustodio::CompressedFile::close ()
+{
+  if ( this->m_Descriptor >= 0 )
+    ::close( this->m_Descriptor );
+
+  this->m_Descriptor = -1;
+  this->m_Format = Format::Plain;
+  this->m_Decoder.reset();
+  std::vector< char >().swap( this->m_Input );
+}
+
+std::size_t Qustodio::CompressedFile::fill ()
+{
+  Decoder &decoder = * this->m_Decoder;
+  decoder.inputFirst = 0;
+  decoder.inputLast = readSome( this->m_Descriptor, this->m_Input.data(), this->m_Input.size() );
+  return decoder.inputLast;
+}
+
+std::size_t Qustodio::CompressedFile::read ( char *buffer, std::size_t size )
+{
+  if ( !this->is_open() || 0 == size )
+    return 0;
+
+  if ( Format::Plain == this->m_Format )
+    return readSome( this->m_Descriptor, buffer, size );
+
+  Decoder &decoder = * this->m_Decoder;
+  std::size_t produced = 0;
+
+  // a decoder may take some input before it gives any output back
+  while ( 0 == produced )
+  {
+    if ( decoder.inputFirst == decoder.inputLast && 0 == this->fill() )
+    {
+      if ( !decoder.atBoundary )
+        throw std::runtime_error( "CompressedFile: truncated compressed data" );
+      return 0;
+    }
+
+#if COMPRESSEDFILE_ZLIB
+    if ( Format::Gzip == this->m_Format )
+    {
+      z_stream &stream = decoder.zlib;
+      stream.next_in = reinterpret_cast< Bytef * >( this->m_Input.data() + decoder.inputFirst );
+      stream.avail_in = static_cast< uInt >( decoder.inputLast - decoder.inputFirst );
+      stream.next_out = reinterpret_cast< Bytef * >( buffer );
+      stream.avail_out = static_cast< uInt >( size > 1u << 30 ? 1u << 30 : size );
+
+      const int result = inflate( & stream, Z_NO_FLUSH );
+      if ( Z_OK != result && Z_STREAM_END != result && Z_BUF_ERROR != result )
+        throw std::runtime_error( std::string( "CompressedFile: " ) + ( stream.msg ? stream.msg : "corrupt gzip data" ) );
+
+      produced = static_cast< std::size_t >( reinterpret_cast< char * >( stream.next_out ) - buffer );
+      decoder.inputFirst = static_cast< std::size_t >( reinterpret_cast< char * >( stream.next_in ) - this->m_Input.data() );
+      decoder.atBoundary = Z_STREAM_END == result;
+      // the next member, if any, starts right after this one
+      if ( Z_STREAM_END == result )
+        inflateReset( & stream );
+    }
+#endif
+  }
+
+  return produced;
+}
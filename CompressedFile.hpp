@@ -0,0 +1,125 @@
+/** @file
+ * @brief Compressed File
+ *
+ * This file contains the sequential reader of the gzip compressed logs
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref CompressedFile_legal_note_sec
+ *
+ * @section CompressedFile_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section CompressedFile_intro_sec Introduction
+ *
+ * The archived logs are compressed, and decompressing them to disk before reading them costs several times their
+ * size in I/O. The reader recognizes the format of a file by its first bytes and hands back its decompressed bytes
+ * block by block, so a log is decompressed in memory as it is parsed. Files that are not compressed are read as they
+ * are. Several gzip members one after the other, as written by `cat a.gz b.gz`, are read as one. zstd files are
+ * recognized but not decoded, see CompressedFile::supported.
+ *
+ * @section CompressedFile_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section CompressedFile_install_sec Use
+ *
+ * @subsection CompressedFile_step1 Requirements
+ * Requires C++11 to use it correctly. The gzip decoder is optional: build with `-DCOMPRESSEDFILE_ZLIB=1 -lz` to read
+ * gzip, see CompressedFile::supported.
+ */
+
+#ifndef COMPRESSEDFILE_HPP
+#define COMPRESSEDFILE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class CompressedFile CompressedFile.hpp "CompressedFile.hpp"
+ *  \brief RAII sequential reader of a file, decompressing it when it is compressed.
+ *
+ * Not synchronized, a single thread reads it at a time.
+ */
+  class CompressedFile
+  {
+    public:
+    /**
+     * @brief How the bytes of a file are stored
+     */
+    enum class Format
+    {
+      Plain, //< Not compressed, or not in a known format
+      Gzip,  //< gzip, starting with `1f 8b`
+      Zstd   //< zstd, starting with `28 b5 2f fd`, recognized so it is not parsed as text but never supported
+    };
+
+    CompressedFile ();
+
+    ~CompressedFile ();
+
+    CompressedFile ( const CompressedFile & ) = delete;
+
+    CompressedFile &operator= ( const CompressedFile & ) = delete;
+
+    /**
+     * @brief The format of a file, from its first bytes
+     * @param fileToRead [in] the file to look at
+     * @return Format::Plain as well when the file can't be read or is not a regular file, such as a pipe
+     */
+    static Format detect ( const std::string &fileToRead );
+
+    /**
+     * @brief True when this build can decompress #format
+     *
+     * Format::Gzip needs a build with zlib, Format::Zstd is not supported by any build.
+     */
+    static bool supported ( Format format );
+
+    /**
+     * @brief Opens a file, releasing any previous one
+     * @param fileToRead [in] the file to read
+     * @return false when the file can't be opened or its format is not #supported
+     */
+    bool open ( const std::string &fileToRead );
+
+    /**
+     * @brief Closes the file
+     */
+    void close ();
+
+    /**
+     * @brief Reads the next decompressed bytes, waiting for at least one unless the file ends
+     * @param buffer [out] where the bytes are written
+     * @param size [in] the most bytes to write
+     * @return the number of bytes written, 0 at the end of the file
+     * @throw std::runtime_error when the file can't be read or the compressed data is corrupt or truncated
+     */
+    std::size_t read ( char *buffer, std::size_t size );
+
+    Format format () const { return m_Format; }     //< The format of the open file
+    bool is_open () const { return m_Descriptor >= 0; } //< True when #open succeeded
+
+    private:
+    struct Decoder;
+
+    /**
+     * @brief Reads the next compressed bytes to #m_Input
+     * @return the number of bytes read, 0 at the end of the file
+     */
+    std::size_t fill ();
+
+    int m_Descriptor = -1;              //< The open file
+    Format m_Format = Format::Plain;    //< See #format
+    std::vector< char > m_Input;        //< The compressed bytes being decoded
+    std::unique_ptr< Decoder > m_Decoder; //< The state of the decoder of #m_Format
+  };
+
+} // namespace Qustodio
+
+#endif // COMPRESSEDFILE_HPP
@@ -0,0 +1,282 @@
+#include "DomainBlocklist.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+const std::size_t Qustodio::DomainBlocklist::MaxHostLength;
+const std::size_t Qustodio::DomainBlocklist::BucketSlots;
+const std::size_t Qustodio::DomainBlocklist::BloomHashes;
+const std::size_t Qustodio::DomainBlocklist::BloomBitsPerDomain;
+const std::size_t Qustodio::DomainBlocklist::MaxKicks;
+
+namespace
+{
+  inline char lowerAscii ( char character )
+  {
+    return character >= 'A' && character <= 'Z' ? static_cast< char >( character - 'A' + 'a' ) : character;
+  }
+
+  // finalizer of MurmurHash3, spreads every input bit over the whole word
+  inline std::uint64_t mix ( std::uint64_t value )
+  {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+  }
+
+  inline std::size_t powerOfTwoAtLeast ( std::size_t value )
+  {
+    std::size_t power = 1;
+    while ( power < value )
+      power <<= 1;
+    return power;
+  }
+} // namespace
+
+Qustodio::DomainBlocklist::DomainBlocklist ( const std::vector< std::string > &domains )
+{
+  const std::size_t bloomBits = powerOfTwoAtLeast( std::max< std::size_t >( 64, domains.size() * BloomBitsPerDomain ) );
+  this->bloom.assign( bloomBits / 64, 0 );
+  this->bloomMask = bloomBits - 1;
+
+  // about 75% full with four slots per bucket
+  const std::size_t buckets = powerOfTwoAtLeast( domains.size() / 3 + 1 );
+  this->slots.assign( buckets * BucketSlots, Slot { 0, 0, 0 } );
+  this->bucketMask = buckets - 1;
+
+  for ( auto &&domain: domains )
+  {
+    std::size_t first = 0;
+    std::size_t last = domain.size();
+    if ( domain.compare( 0, 2, "*." ) == 0 )
+      first = 2;
+    else if ( first < last && '.' == domain[first] )
+      first = 1;
+    if ( last > first && '.' == domain[last - 1] )
+      --last;
+
+    const std::size_t length = last - first;
+    if ( 0 == length || length > MaxHostLength
+         || this->names.size() + length > std::numeric_limits< std::uint32_t >::max() )
+      continue;
+
+    const std::size_t offset = this->names.size();
+    for ( std::size_t i = first; i < last; ++i )
+      this->names.push_back( lowerAscii( domain[i] ) );
+
+    const char *name = this->names.data() + offset;
+    const std::uint64_t domainHash = hash( name, length );
+    if ( this->find( domainHash, name, length ) )
+    {
+      this->names.resize( offset );
+      continue;
+    }
+
+    Slot slot = { domainHash, static_cast< std::uint32_t >( offset ), static_cast< std::uint32_t >( length ) };
+    // a failed placement leaves in #slot the entry that was displaced last
+    while ( !this->place( slot ) )
+      this->rebuild( 2 * ( this->bucketMask + 1 ) );
+
+    this->bloomInsert( domainHash );
+    ++this->domainCount;
+  }
+}
+
+bool Qustodio::DomainBlocklist::matches ( StringRef url ) const
+{
+  char host[MaxHostLength];
+  std::size_t length = 0;
+  if ( !extractHost( url, host, length ) )
+    return false;
+
+  // the host and every parent domain, one label less each time
+  for ( std::size_t start = 0; start < length; )
+  {
+    const char *suffix = host + start;
+    const std::size_t suffixLength = length - start;
+    const std::uint64_t suffixHash = hash( suffix, suffixLength );
+    if ( this->bloomMayContain( suffixHash ) && this->find( suffixHash, suffix, suffixLength ) )
+      return true;
+
+    const void *dot = std::memchr( suffix, '.', suffixLength );
+    if ( nullptr == dot )
+      break;
+    start = static_cast< std::size_t >( static_cast< const char * >( dot ) - host ) + 1;
+  }
+  return false;
+}
+
+bool Qustodio::DomainBlocklist::contains ( StringRef domain ) const
+{
+  const std::uint64_t domainHash = hash( domain.data(), domain.size() );
+  return this->bloomMayContain( domainHash ) && this->find( domainHash, domain.data(), domain.size() );
+}
+
+std::size_t Qustodio::DomainBlocklist::memoryUsage () const
+{
+  return this->bloom.capacity() * sizeof( std::uint64_t ) + this->slots.capacity() * sizeof( Slot )
+         + this->names.capacity();
+}
+
+bool Qustodio::DomainBlocklist::extractHost ( StringRef url, char *host, std::size_t &length )
+{
+  const char *first = url.begin();
+  const char *const last = url.end();
+
+  // scheme, only when `://` comes before any path
+  for ( const char *cursor = first; cursor != last; ++cursor )
+  {
+    if ( '/' == * cursor || '?' == * cursor || '#' == * cursor )
+      break;
+    if ( ':' == * cursor )
+    {
+      if ( last - cursor >= 3 && '/' == cursor[1] && '/' == cursor[2] )
+        first = cursor + 3;
+      break;
+    }
+  }
+  if ( last - first >= 2 && '/' == first[0] && '/' == first[1] )
+    first += 2;
+
+  // the authority ends at the path, the query or the fragment
+  const char *authorityEnd = first;
+  while ( authorityEnd != last && '/' != * authorityEnd && '?' != * authorityEnd && '#' != * authorityEnd )
+    ++authorityEnd;
+
+  // user information
+  for ( const char *cursor = authorityEnd; cursor != first; --cursor )
+    if ( '@' == * ( cursor - 1 ) )
+    {
+      first = cursor;
+      break;
+    }
+
+  // port, an IPv6 literal keeps its brackets
+  const char *hostEnd = first;
+  if ( hostEnd != authorityEnd && '[' == * hostEnd )
+  {
+    while ( hostEnd != authorityEnd && ']' != * hostEnd )
+      ++hostEnd;
+    if ( hostEnd != authorityEnd )
+      ++hostEnd;
+  }
+  else
+    while ( hostEnd != authorityEnd && ':' != * hostEnd )
+      ++hostEnd;
+
+  if ( hostEnd != first && '.' == * ( hostEnd - 1 ) )
+    --hostEnd;
+
+  length = static_cast< std::size_t >( hostEnd - first );
+  if ( 0 == length || length > MaxHostLength )
+    return false;
+
+  for ( std::size_t i = 0; i < length; ++i )
+    host[i] = lowerAscii( first[i] );
+  return true;
+}
+
+std::uint64_t Qustodio::DomainBlocklist::hash ( const char *first, std::size_t length )
+{
+  // FNV-1a
+  std::uint64_t value = 14695981039346656037ull;
+  for ( std::size_t i = 0; i < length; ++i )
+  {
+    value ^= static_cast< unsigned char >( first[i] );
+    value *= 1099511628211ull;
+  }
+  value = mix( value );
+  return 0 == value ? 1 : value;
+}
+
+bool Qustodio::DomainBlocklist::bloomMayContain ( std::uint64_t hash ) const
+{
+  // double hashing, the bit i is hash + i * step
+  const std::uint64_t step = mix( hash ^ 0x9E3779B97F4A7C15ull ) | 1;
+  for ( std::size_t i = 0; i < BloomHashes; ++i )
+  {
+    const std::uint64_t bit = ( hash + i * step ) & this->bloomMask;
+    if ( 0 == ( this->bloom[bit >> 6] & ( std::uint64_t( 1 ) << ( bit & 63 ) ) ) )
+      return false;
+  }
+  return true;
+}
+
+void Qustodio::DomainBlocklist::bloomInsert ( std::uint64_t hash )
+{
+  const std::uint64_t step = mix( hash ^ 0x9E3779B97F4A7C15ull ) | 1;
+  for ( std::size_t i = 0; i < BloomHashes; ++i )
+  {
+    const std::uint64_t bit = ( hash + i * step ) & this->bloomMask;
+    this->bloom[bit >> 6] |= std::uint64_t( 1 ) << ( bit & 63 );
+  }
+}
+
+bool Qustodio::DomainBlocklist::find ( std::uint64_t hash, const char *first, std::size_t length ) const
+{
+  const std::size_t buckets[2] = { this->firstBucket( hash ), this->secondBucket( hash ) };
+  for ( std::size_t bucket: buckets )
+  {
+    const Slot *slot = this->slots.data() + bucket * BucketSlots;
+    for ( std::size_t i = 0; i < BucketSlots; ++i, ++slot )
+      if ( slot->hash == hash && slot->length == length
+           && 0 == std::memcmp( this->names.data() + slot->offset, first, length ) )
+        return true;
+  }
+  return false;
+}
+
+bool Qustodio::DomainBlocklist::place ( Slot &slot )
+{
+  std::size_t bucket = this->firstBucket( slot.hash );
+  for ( std::size_t kick = 0; kick < MaxKicks; ++kick )
+  {
+    const std::size_t buckets[2] = { this->firstBucket( slot.hash ), this->secondBucket( slot.hash ) };
+    for ( std::size_t candidate: buckets )
+    {
+      Slot *target = this->slots.data() + candidate * BucketSlots;
+      for ( std::size_t i = 0; i < BucketSlots; ++i, ++target )
+        if ( 0 == target->hash )
+        {
+          * target = slot;
+          return true;
+        }
+    }
+
+    // both buckets are full: take the place of a resident, which moves to its other bucket
+    std::swap( slot, this->slots[bucket * BucketSlots + kick % BucketSlots] );
+    bucket = bucket == this->firstBucket( slot.hash ) ? this->secondBucket( slot.hash )
+                                                       : this->firstBucket( slot.hash );
+  }
+  return false;
+}
+
+void Qustodio::DomainBlocklist::rebuild ( std::size_t buckets )
+{
+  std::vector< Slot > previous;
+  previous.swap( this->slots );
+
+  for ( ;; buckets *= 2 )
+  {
+    this->slots.assign( buckets * BucketSlots, Slot { 0, 0, 0 } );
+    this->bucketMask = buckets - 1;
+
+    bool placed = true;
+    for ( auto &&entry: previous )
+    {
+      Slot moving = entry;
+      if ( 0 != moving.hash && !this->place( moving ) )
+      {
+        placed = false;
+        break;
+      }
+    }
+    if ( placed )
+      return;
+  }
+}
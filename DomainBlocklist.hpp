@@ -0,0 +1,146 @@
+/** @file
+ * @brief Domain Blocklist
+ *
+ * This file contains the hashed blocklist of domains used to block whole sites and their subdomains
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref DomainBlocklist_legal_note_sec
+ *
+ * @section DomainBlocklist_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section DomainBlocklist_intro_sec Introduction
+ *
+ * A rule such as `example.com` blocks that host and every subdomain of it. Instead of scanning the url for every
+ * rule, the host is extracted from the url, normalized, and each of its suffixes made of whole labels is looked up:
+ * `a.b.example.com`, `b.example.com`, `example.com` and `com`. That is O(labels) lookups whatever the size of the
+ * list.
+ *
+ * Every lookup first asks a Bloom filter of about ten bits per domain, which answers no for almost every host that is
+ * not listed without touching the table. The domains themselves live in a bucketized cuckoo hash table: two candidate
+ * buckets of four slots per domain, so a lookup reads at most two cache lines of slots and compares bytes only when the
+ * whole 64 bit hash matches.
+ *
+ * @section DomainBlocklist_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section DomainBlocklist_install_sec Use
+ *
+ * @subsection DomainBlocklist_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef DOMAINBLOCKLIST_HPP
+#define DOMAINBLOCKLIST_HPP
+
+#include "StringRef.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class DomainBlocklist DomainBlocklist.hpp "DomainBlocklist.hpp"
+ *  \brief Blocklist of domains and their subdomains, with a Bloom filter in front of a cuckoo hash table.
+ *
+ * Immutable once built, so a single instance can be shared by every worker of a #ComposerPool.
+ */
+  class DomainBlocklist
+  {
+    public:
+    static const std::size_t MaxHostLength = 255; //< Longest host looked up, longer ones never match
+
+    /**
+     * @brief Builds the blocklist
+     * @param domains [in] the blocked domains, normalized as the hosts: lower case, without a trailing dot. A leading
+     * `*.` or `.` is ignored, the subdomains are always blocked. Empty entries are ignored
+     */
+    explicit DomainBlocklist ( const std::vector< std::string > &domains );
+
+    /**
+     * @brief Checks whether the host of #url, or any domain it belongs to, is blocked
+     */
+    bool matches ( StringRef url ) const;
+
+    /**
+     * @brief Checks whether #domain itself is listed, without looking at its parents
+     * @param domain [in] a normalized domain
+     */
+    bool contains ( StringRef domain ) const;
+
+    std::size_t size () const { return domainCount; } //< Number of distinct listed domains
+
+    /**
+     * @brief Bytes used by the filter, the table and the domain names
+     */
+    std::size_t memoryUsage () const;
+
+    /**
+     * @brief Extracts the normalized host of a url
+     *
+     * Skips the scheme and the user information, stops at the port, path, query or fragment, lowers the case and
+     * drops a trailing dot. A url without scheme, such as `example.com/path`, is accepted too.
+     * @param url [in] the url
+     * @param host [out] a buffer of at least #MaxHostLength characters receiving the host
+     * @param length [out] the length of the host
+     * @return false when the url has no host or it is longer than #MaxHostLength
+     */
+    static bool extractHost ( StringRef url, char *host, std::size_t &length );
+
+    private:
+    static const std::size_t BucketSlots = 4;      //< Slots of every bucket of the cuckoo table
+    static const std::size_t BloomHashes = 7;      //< Bits set per domain in the Bloom filter
+    static const std::size_t BloomBitsPerDomain = 10;
+    static const std::size_t MaxKicks = 500;       //< Displacements tried before growing the cuckoo table
+
+    struct Slot
+    {
+      std::uint64_t hash;   //< 0 for an empty slot, the hashes are never 0
+      std::uint32_t offset; //< First character of the domain in #names
+      std::uint32_t length; //< Length of the domain
+    };
+
+    static std::uint64_t hash ( const char *first, std::size_t length );
+
+    std::size_t firstBucket ( std::uint64_t hash ) const { return static_cast< std::size_t >( hash ) & bucketMask; }
+    std::size_t secondBucket ( std::uint64_t hash ) const
+    {
+      return static_cast< std::size_t >( ( hash >> 32 ) * 0x9E3779B97F4A7C15ull >> 16 ) & bucketMask;
+    }
+
+    bool bloomMayContain ( std::uint64_t hash ) const;
+    void bloomInsert ( std::uint64_t hash );
+
+    /**
+     * @brief Looks a hashed domain up in the cuckoo table
+     */
+    bool find ( std::uint64_t hash, const char *first, std::size_t length ) const;
+
+    /**
+     * @brief Places #slot in the cuckoo table, displacing other slots if needed
+     * @return false when no place was found after #MaxKicks displacements, #slot then holds the entry left out
+     */
+    bool place ( Slot &slot );
+
+    /**
+     * @brief Rebuilds the cuckoo table with #buckets buckets
+     */
+    void rebuild ( std::size_t buckets );
+
+    std::vector< std::uint64_t > bloom;  //< Bits of the Bloom filter
+    std::uint64_t bloomMask = 0;         //< Number of bits of #bloom minus one
+    std::vector< Slot > slots;           //< Buckets of #BucketSlots slots
+    std::size_t bucketMask = 0;          //< Number of buckets minus one
+    std::vector< char > names;           //< The listed domains, one after the other
+    std::size_t domainCount = 0;         //< Number of distinct listed domains
+  };
+
+} // namespace Qustodio
+
+#endif // DOMAINBLOCKLIST_HPP
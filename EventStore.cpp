@@ -0,0 +1,519 @@
+#include "EventStore.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+const std::uint64_t Qustodio::EventStore::InvalidMac;
+const std::int64_t Qustodio::EventStore::InvalidTimestamp;
+const std::size_t Qustodio::EventStore::TimeBlockSize;
+
+namespace
+{
+  const char snapshotMagic[8] = { 'Q', 'B', 'E', 'V', 'S', 'N', 'A', 'P' };
+  const std::uint32_t snapshotVersion = 2;
+  const std::uint32_t snapshotByteOrder = 0x01020304u; //< Reads differently on a machine of the other endianness
+
+  struct SnapshotHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t events;
+    std::uint64_t devices;
+    std::uint64_t urlBytes;
+    std::uint64_t deviceBytes;
+    std::uint64_t fileSize;
+    std::uint64_t checksum; //< FNV-1a of the bytes above
+  };
+
+  static_assert( sizeof( SnapshotHeader ) == 64, "the snapshot header is 64 bytes" );
+
+  /**
+   * @brief Where every section of a snapshot starts
+   */
+  struct SnapshotLayout
+  {
+    std::uint64_t timestamps;
+    std::uint64_t macs;
+    std::uint64_t urlOffsets;
+    std::uint64_t deviceOffsets;
+    std::uint64_t deviceEventOffsets;
+    std::uint64_t deviceEvents;
+    std::uint64_t deviceIds;
+    std::uint64_t urlArena;
+    std::uint64_t deviceNames;
+    std::uint64_t end;
+  };
+
+  inline std::uint64_t alignSection ( std::uint64_t offset )
+  {
+    return ( offset + 7 ) & ~std::uint64_t( 7 );
+  }
+
+  /**
+   * @brief Computes the layout of #header, false when the sizes overflow
+   */
+  bool snapshotLayout ( const SnapshotHeader &header, SnapshotLayout &layout )
+  {
+    // far beyond any file, keeps the products below from overflowing
+    const std::uint64_t limit = std::uint64_t( 1 ) << 56;
+    if ( header.events >= limit || header.devices >= limit || header.urlBytes >= limit || header.deviceBytes >= limit )
+      return false;
+
+    layout.timestamps = sizeof( SnapshotHeader );
+    layout.macs = layout.timestamps + 8 * header.events;
+    layout.urlOffsets = layout.macs + 8 * header.events;
+    layout.deviceOffsets = layout.urlOffsets + 8 * ( header.events + 1 );
+    layout.deviceEventOffsets = layout.deviceOffsets + 8 * ( header.devices + 1 );
+    layout.deviceEvents = layout.deviceEventOffsets + 8 * ( header.devices + 1 );
+    layout.deviceIds = layout.deviceEvents + 8 * header.events;
+    layout.urlArena = alignSection( layout.deviceIds + 4 * header.events );
+    layout.deviceNames = alignSection( layout.urlArena + header.urlBytes );
+    layout.end = layout.deviceNames + header.deviceBytes;
+    return true;
+  }
+
+  std::uint64_t headerChecksum ( const SnapshotHeader &header )
+  {
+    const unsigned char *bytes = reinterpret_cast< const unsigned char * >( & header );
+    std::uint64_t hash = 14695981039346656037ull;
+    for ( std::size_t i = 0; i < offsetof( SnapshotHeader, checksum ); ++i )
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  /**
+   * @brief True when #offsets starts at zero, never decreases and ends at #bytes
+   */
+  bool validOffsets ( const std::uint64_t *offsets, std::uint64_t count, std::uint64_t bytes )
+  {
+    if ( 0 != offsets[0] || bytes != offsets[count] )
+      return false;
+    for ( std::uint64_t i = 0; i < count; ++i )
+      if ( offsets[i] > offsets[i + 1] )
+        return false;
+    return true;
+  }
+
+  void writePadding ( std::ofstream &out, std::uint64_t offset )
+  {
+    static const char zeros[8] = { 0 };
+    out.write( zeros, static_cast< std::streamsize >( alignSection( offset ) - offset ) );
+  }
+
+  template < class T >
+  void writeColumn ( std::ofstream &out, const T *values, std::size_t count )
+  {
+    if ( count > 0 )
+      out.write( reinterpret_cast< const char * >( values ), static_cast< std::streamsize >( count * sizeof( T ) ) );
+  }
+
+  inline int hexValue ( char character )
+  {
+    if ( character >= '0' && character <= '9' )
+      return character - '0';
+    if ( character >= 'a' && character <= 'f' )
+      return character - 'a' + 10;
+    if ( character >= 'A' && character <= 'F' )
+      return character - 'A' + 10;
+    return -1;
+  }
+} // namespace
+
+void Qustodio::EventStore::append ( StringRef url, StringRef device, StringRef timestamp )
+{
+  std::uint64_t mac = InvalidMac;
+  if ( !parseMac( device, mac ) )
+    mac = InvalidMac;
+
+  std::int64_t seconds = InvalidTimestamp;
+  if ( !parseTimestamp( timestamp, seconds ) )
+    seconds = InvalidTimestamp;
+
+  this->urlArena.append( url.begin(), url.end() );
+  this->urlOffsets.push_back( this->urlArena.size() );
+  this->timestamps.push_back( seconds );
+  this->macs.push_back( mac );
+  const std::uint32_t id = this->intern( device, mac );
+  this->deviceIds.push_back( id );
+  this->deviceEventLists[id].push_back( this->size() - 1 );
+
+  // the first event of a block opens it in the time index
+  if ( 0 == ( this->size() - 1 ) % TimeBlockSize )
+  {
+    this->blockMinimum.push_back( std::numeric_limits< std::int64_t >::max() );
+    this->blockMaximum.push_back( InvalidTimestamp );
+  }
+  if ( InvalidTimestamp != seconds )
+  {
+    this->blockMinimum.back() = std::min( this->blockMinimum.back(), seconds );
+    this->blockMaximum.back() = std::max( this->blockMaximum.back(), seconds );
+  }
+}
+
+void Qustodio::EventStore::append ( const Qustodio::BrowsingEvent &event )
+{
+  this->append( event.Url(), event.Device(), event.Timestamp() );
+}
+
+void Qustodio::EventStore::append ( const Qustodio::BrowsingEventView &event )
+{
+  this->append( event.Url(), event.Device(), event.Timestamp() );
+}
+
+void Qustodio::EventStore::append ( EventStore &&shard )
+{
+  if ( this->empty() && this->deviceNames.empty() )
+  {
+    // the deque keeps the dictionary keys valid across the move
+    * this = std::move( shard );
+    shard.clear();
+    return;
+  }
+
+  this->append( static_cast< const EventStore & >( shard ) );
+  shard.clear();
+}
+
+void Qustodio::EventStore::append ( const EventStore &shard )
+{
+  std::vector< std::uint32_t > deviceMap;
+  deviceMap.reserve( shard.deviceNames.size() );
+  for ( auto &&name: shard.deviceNames )
+  {
+    std::uint64_t mac = InvalidMac;
+    if ( !parseMac( name, mac ) )
+      mac = InvalidMac;
+    deviceMap.push_back( this->intern( name, mac ) );
+  }
+
+  const std::uint64_t urlBase = this->urlArena.size();
+  this->urlArena.append( shard.urlArena.begin(), shard.urlArena.end() );
+  this->urlOffsets.reserve( this->urlOffsets.size() + shard.size() );
+  for ( std::size_t i = 1; i < shard.urlOffsets.size(); ++i )
+    this->urlOffsets.push_back( urlBase + shard.urlOffsets[i] );
+
+  this->timestamps.append( shard.timestamps.begin(), shard.timestamps.end() );
+  this->macs.append( shard.macs.begin(), shard.macs.end() );
+  this->deviceIds.reserve( this->deviceIds.size() + shard.size() );
+  const std::uint64_t eventBase = this->size() - shard.size();
+  for ( std::uint32_t id: shard.deviceIds )
+    this->deviceIds.push_back( deviceMap[id] );
+  for ( std::size_t id = 0; id < shard.deviceEventLists.size(); ++id )
+  {
+    Column< std::uint64_t > &events = this->deviceEventLists[deviceMap[id]];
+    for ( std::uint64_t event: shard.deviceEventLists[id] )
+      events.push_back( eventBase + event );
+  }
+
+  this->indexTimestamps( this->size() - shard.size() );
+}
+
+void Qustodio::EventStore::reserve ( std::size_t events, std::size_t urlBytes )
+{
+  this->timestamps.reserve( events );
+  this->macs.reserve( events );
+  this->deviceIds.reserve( events );
+  this->urlOffsets.reserve( events + 1 );
+  this->urlArena.reserve( urlBytes );
+}
+
+void Qustodio::EventStore::clear ()
+{
+  this->timestamps.clear();
+  this->macs.clear();
+  this->deviceIds.clear();
+  this->urlOffsets.clear();
+  this->urlOffsets.push_back( 0 );
+  this->urlArena.clear();
+  this->deviceIndex.clear();
+  this->deviceNames.clear();
+  this->macIndex.clear();
+  this->deviceEventLists.clear();
+  this->blockMinimum.clear();
+  this->blockMaximum.clear();
+  this->snapshot.reset();
+}
+
+bool Qustodio::EventStore::save ( const std::string &fileToWrite ) const
+{
+  SnapshotHeader header;
+  std::memset( & header, 0, sizeof( header ) );
+  std::memcpy( header.magic, snapshotMagic, sizeof( header.magic ) );
+  header.version = snapshotVersion;
+  header.byteOrder = snapshotByteOrder;
+  header.events = this->size();
+  header.devices = this->deviceNames.size();
+  header.urlBytes = this->urlArena.size();
+
+  std::vector< std::uint64_t > deviceOffsets( 1, 0 );
+  deviceOffsets.reserve( this->deviceNames.size() + 1 );
+  for ( auto &&name: this->deviceNames )
+    deviceOffsets.push_back( deviceOffsets.back() + name.size() );
+  header.deviceBytes = deviceOffsets.back();
+
+  std::vector< std::uint64_t > deviceEventOffsets( 1, 0 );
+  deviceEventOffsets.reserve( this->deviceEventLists.size() + 1 );
+  for ( auto &&events: this->deviceEventLists )
+    deviceEventOffsets.push_back( deviceEventOffsets.back() + events.size() );
+
+  SnapshotLayout layout;
+  if ( !snapshotLayout( header, layout ) )
+    return false;
+  header.fileSize = layout.end;
+  header.checksum = headerChecksum( header );
+
+  const std::string temporary = fileToWrite + ".tmp";
+  std::ofstream out( temporary, std::ios::binary | std::ios::trunc );
+  if ( !out.is_open() )
+    return false;
+
+  out.write( reinterpret_cast< const char * >( & header ), sizeof( header ) );
+  writeColumn( out, this->timestamps.data(), this->timestamps.size() );
+  writeColumn( out, this->macs.data(), this->macs.size() );
+  writeColumn( out, this->urlOffsets.data(), this->urlOffsets.size() );
+  writeColumn( out, deviceOffsets.data(), deviceOffsets.size() );
+  writeColumn( out, deviceEventOffsets.data(), deviceEventOffsets.size() );
+  for ( auto &&events: this->deviceEventLists )
+    writeColumn( out, events.data(), events.size() );
+  writeColumn( out, this->deviceIds.data(), this->deviceIds.size() );
+  writePadding( out, layout.deviceIds + 4 * header.events );
+  writeColumn( out, this->urlArena.data(), this->urlArena.size() );
+  writePadding( out, layout.urlArena + header.urlBytes );
+  for ( auto &&name: this->deviceNames )
+    out.write( name.data(), static_cast< std::streamsize >( name.size() ) );
+
+  out.close();
+  if ( out.fail() || 0 != std::rename( temporary.c_str(), fileToWrite.c_str() ) )
+  {
+    std::remove( temporary.c_str() );
+    return false;
+  }
+  return true;
+}
+
+bool Qustodio::EventStore::load ( const std::string &fileToRead )
+{
+  auto mapping = std::make_shared< Qustodio::MappedFile >();
+  if ( !mapping->open( fileToRead ) || mapping->size() < sizeof( SnapshotHeader ) )
+    return false;
+
+  SnapshotHeader header;
+  std::memcpy( & header, mapping->data(), sizeof( header ) );
+  SnapshotLayout layout;
+  if ( 0 != std::memcmp( header.magic, snapshotMagic, sizeof( header.magic ) )
+       || snapshotVersion != header.version || snapshotByteOrder != header.byteOrder
+       || headerChecksum( header ) != header.checksum
+       || !snapshotLayout( header, layout ) || header.fileSize != layout.end || mapping->size() != layout.end )
+    return false;
+
+  // the mapping is page aligned and every section starts at a multiple of 8 bytes
+  const char *const base = mapping->data();
+  const std::size_t events = static_cast< std::size_t >( header.events );
+  const std::size_t devices = static_cast< std::size_t >( header.devices );
+  const std::uint64_t *urlOffsets = reinterpret_cast< const std::uint64_t * >( base + layout.urlOffsets );
+  const std::uint64_t *deviceOffsets = reinterpret_cast< const std::uint64_t * >( base + layout.deviceOffsets );
+  const std::uint64_t *deviceEventOffsets = reinterpret_cast< const std::uint64_t * >( base + layout.deviceEventOffsets );
+  const std::uint64_t *deviceEvents = reinterpret_cast< const std::uint64_t * >( base + layout.deviceEvents );
+  const std::uint32_t *deviceIds = reinterpret_cast< const std::uint32_t * >( base + layout.deviceIds );
+
+  if ( !validOffsets( urlOffsets, header.events, header.urlBytes )
+       || !validOffsets( deviceOffsets, header.devices, header.deviceBytes )
+       || !validOffsets( deviceEventOffsets, header.devices, header.events ) )
+    return false;
+  for ( std::size_t i = 0; i < events; ++i )
+    if ( deviceIds[i] >= header.devices )
+      return false;
+  // every list is increasing and only holds events of its device, so together they hold every event once
+  for ( std::size_t id = 0; id < devices; ++id )
+    for ( std::uint64_t e = deviceEventOffsets[id]; e < deviceEventOffsets[id + 1]; ++e )
+      if ( deviceEvents[e] >= header.events || id != deviceIds[deviceEvents[e]]
+           || ( e > deviceEventOffsets[id] && deviceEvents[e] <= deviceEvents[e - 1] ) )
+        return false;
+
+  EventStore loaded;
+  loaded.timestamps.reference( reinterpret_cast< const std::int64_t * >( base + layout.timestamps ), events );
+  loaded.macs.reference( reinterpret_cast< const std::uint64_t * >( base + layout.macs ), events );
+  loaded.deviceIds.reference( deviceIds, events );
+  loaded.urlOffsets.reference( urlOffsets, events + 1 );
+  loaded.urlArena.reference( base + layout.urlArena, static_cast< std::size_t >( header.urlBytes ) );
+
+  const char *const names = base + layout.deviceNames;
+  for ( std::size_t id = 0; id < devices; ++id )
+  {
+    loaded.deviceNames.emplace_back( names + deviceOffsets[id],
+                                     static_cast< std::size_t >( deviceOffsets[id + 1] - deviceOffsets[id] ) );
+    loaded.deviceIndex.emplace( StringRef( loaded.deviceNames.back() ), static_cast< std::uint32_t >( id ) );
+    std::uint64_t mac = InvalidMac;
+    if ( parseMac( loaded.deviceNames.back(), mac ) )
+      loaded.macIndex.insert( mac, static_cast< std::uint32_t >( id ) );
+  }
+
+  loaded.deviceEventLists.resize( devices );
+  for ( std::size_t id = 0; id < devices; ++id )
+    loaded.deviceEventLists[id].reference( deviceEvents + deviceEventOffsets[id],
+                                           static_cast< std::size_t >( deviceEventOffsets[id + 1] - deviceEventOffsets[id] ) );
+
+  loaded.indexTimestamps( 0 );
+  loaded.snapshot = mapping;
+  * this = std::move( loaded );
+  return true;
+}
+
+std::int64_t Qustodio::EventStore::latestTimestamp () const
+{
+  std::int64_t latest = InvalidTimestamp;
+  for ( std::int64_t maximum: this->blockMaximum )
+    latest = std::max( latest, maximum );
+  return latest;
+}
+
+std::size_t Qustodio::EventStore::memoryUsage () const
+{
+  std::size_t bytes = this->timestamps.capacity() * sizeof( std::int64_t )
+                      + this->macs.capacity() * sizeof( std::uint64_t )
+                      + this->deviceIds.capacity() * sizeof( std::uint32_t )
+                      + this->urlOffsets.capacity() * sizeof( std::uint64_t )
+                      + this->urlArena.capacity()
+                      + ( this->blockMinimum.capacity() + this->blockMaximum.capacity() ) * sizeof( std::int64_t );
+  for ( auto &&name: this->deviceNames )
+    bytes += sizeof( std::string ) + name.capacity();
+  for ( auto &&events: this->deviceEventLists )
+    bytes += sizeof( events ) + events.capacity() * sizeof( std::uint64_t );
+  bytes += this->macIndex.memoryUsage();
+  return bytes;
+}
+
+void Qustodio::EventStore::timeBlocks ( std::int64_t from, std::int64_t to, std::vector< std::size_t > &blocks ) const
+{
+  for ( std::size_t block = 0; block < this->blockMinimum.size(); ++block )
+    if ( this->blockMinimum[block] < to && this->blockMaximum[block] >= from )
+      blocks.push_back( block );
+}
+
+Qustodio::BrowsingEvent Qustodio::EventStore::browsingEvent ( std::size_t index ) const
+{
+  Qustodio::BrowsingEvent event;
+  const StringRef eventUrl = this->url( index );
+  const StringRef eventDevice = this->device( index );
+  event.Url( eventUrl.data(), eventUrl.size() );
+  event.Device( eventDevice.data(), eventDevice.size() );
+  if ( InvalidTimestamp != this->timestamps[index] )
+    event.Timestamp( std::to_string( this->timestamps[index] ) );
+  return event;
+}
+
+bool Qustodio::EventStore::parseMac ( StringRef device, std::uint64_t &mac )
+{
+  // xx:xx:xx:xx:xx:xx
+  if ( device.size() != 17 )
+    return false;
+
+  std::uint64_t packed = 0;
+  for ( std::size_t i = 0; i < 17; i += 3 )
+  {
+    const int high = hexValue( device[i] );
+    const int low = hexValue( device[i + 1] );
+    if ( high < 0 || low < 0 )
+      return false;
+    if ( i + 2 < 17 && ':' != device[i + 2] && '-' != device[i + 2] )
+      return false;
+    packed = ( packed << 8 ) | static_cast< std::uint64_t >( high << 4 | low );
+  }
+
+  mac = packed;
+  return true;
+}
+
+bool Qustodio::EventStore::parseTimestamp ( StringRef timestamp, std::int64_t &seconds )
+{
+  // up to 18 digits always fit in an int64_t
+  if ( timestamp.empty() || timestamp.size() > 18 )
+    return false;
+
+  std::int64_t value = 0;
+  for ( char character: timestamp )
+  {
+    if ( character < '0' || character > '9' )
+      return false;
+    value = value * 10 + ( character - '0' );
+  }
+
+  seconds = value;
+  return true;
+}
+
+std::size_t Qustodio::EventStore::StringRefHash::operator() ( const StringRef &string ) const
+{
+  // FNV-1a
+  std::uint64_t hash = 14695981039346656037ull;
+  for ( char character: string )
+  {
+    hash ^= static_cast< unsigned char >( character );
+    hash *= 1099511628211ull;
+  }
+  return static_cast< std::size_t >( hash );
+}
+
+bool Qustodio::EventStore::findDevice ( StringRef device, std::uint32_t &id ) const
+{
+  std::uint64_t mac = InvalidMac;
+  if ( parseMac( device, mac ) )
+    return this->macIndex.find( mac, id );
+
+  auto found = this->deviceIndex.find( device );
+  if ( found == this->deviceIndex.end() )
+    return false;
+  id = found->second;
+  return true;
+}
+
+std::uint32_t Qustodio::EventStore::intern ( StringRef device, std::uint64_t mac )
+{
+  std::uint32_t id = 0;
+  // integer lookup for the MAC-Addresses, whatever their spelling
+  if ( InvalidMac != mac && this->macIndex.find( mac, id ) )
+    return id;
+
+  auto found = this->deviceIndex.find( device );
+  if ( found != this->deviceIndex.end() )
+    return found->second;
+
+  id = static_cast< std::uint32_t >( this->deviceNames.size() );
+  this->deviceNames.emplace_back( device.data(), device.size() );
+  this->deviceIndex.emplace( StringRef( this->deviceNames.back() ), id );
+  if ( InvalidMac != mac )
+    this->macIndex.insert( mac, id );
+  this->deviceEventLists.emplace_back();
+  return id;
+}
+
+void Qustodio::EventStore::indexTimestamps ( std::size_t first )
+{
+  // the block of #first may already be partially summarized, start it over
+  const std::size_t firstBlock = first / TimeBlockSize;
+  this->blockMinimum.resize( firstBlock );
+  this->blockMaximum.resize( firstBlock );
+
+  for ( std::size_t begin = firstBlock * TimeBlockSize; begin < this->size(); begin += TimeBlockSize )
+  {
+    const std::size_t end = std::min( begin + TimeBlockSize, this->size() );
+    std::int64_t minimum = std::numeric_limits< std::int64_t >::max();
+    std::int64_t maximum = InvalidTimestamp;
+    for ( std::size_t i = begin; i < end; ++i )
+    {
+      const std::int64_t seconds = this->timestamps[i];
+      if ( InvalidTimestamp == seconds )
+        continue;
+      minimum = std::min( minimum, seconds );
+      maximum = std::max( maximum, seconds );
+    }
+    this->blockMinimum.push_back( minimum );
+    this->blockMaximum.push_back( maximum );
+  }
+}
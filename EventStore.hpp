@@ -0,0 +1,349 @@
+/** @file
+ * @brief Event Store
+ *
+ * This file contains the columnar store of the Browsing Events kept by the Common Storage Component
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref EventStore_legal_note_sec
+ *
+ * @section EventStore_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section EventStore_intro_sec Introduction
+ *
+ * Instead of one object with three std::string per event, the store keeps one array per field:
+ * - the MAC address of the device packed in a uint64_t
+ * - the timestamp parsed into an int64_t
+ * - the device interned to a small integer id
+ * - the url bytes in a contiguous arena plus an offset column
+ *
+ * That is 28 bytes plus the url per event, without any per event heap allocation, and the filters scan the columns
+ * linearly through the #EventStore::Event accessor.
+ *
+ * While appending, the store also indexes every device: the devices are interned through their MAC-Address in a
+ * #MacTable, so the spellings of the same address share one id, and every id keeps the list of its events. A per
+ * device query walks that list instead of the whole store.
+ *
+ * The store also keeps a time index: the smallest and largest timestamp of every block of
+ * #EventStore::TimeBlockSize consecutive events. The logs are roughly ordered by time, so a query over a time window
+ * only visits the few blocks #EventStore::timeBlocks returns instead of the whole store.
+ *
+ * Writers that must not wait for each other fill a store of their own and splice it into the shared one with a single
+ * #EventStore::append when they are done.
+ *
+ * #EventStore::save writes the columns to a versioned binary snapshot, laid out as:
+ * - a 64 bytes header: magic `QBEVSNAP`, version, byte order mark, event and device counts, url and device name
+ *   bytes, file size and the FNV-1a checksum of the preceding header bytes
+ * - the timestamp, MAC, url offset and device name offset columns, 8 bytes per value
+ * - the offsets of the event list of every device and the lists one after the other, 8 bytes per value
+ * - the device id column, 4 bytes per value
+ * - the url bytes and the device name bytes
+ *
+ * Every section starts at a multiple of 8 bytes. #EventStore::load maps the file once and the columns and the event
+ * lists of the devices reference the mapping, so only the device dictionary is allocated.
+ *
+ * @section EventStore_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section EventStore_install_sec Use
+ *
+ * @subsection EventStore_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef EVENTSTORE_HPP
+#define EVENTSTORE_HPP
+
+#include "BrowsingEvent.hpp"
+#include "BrowsingEventView.hpp"
+#include "Column.hpp"
+#include "MacTable.hpp"
+#include "MappedFile.hpp"
+#include "StringRef.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class EventStore EventStore.hpp "EventStore.hpp"
+ *  \brief Struct-of-arrays storage of browsing events.
+ *
+ * Appending is not synchronized, the owner serializes writers.
+ */
+  class EventStore
+  {
+    public:
+    static const std::uint64_t InvalidMac = ~std::uint64_t( 0 );                                 //< Device is not a MAC-Address
+    static const std::int64_t InvalidTimestamp = std::numeric_limits< std::int64_t >::min(); //< Timestamp missing or not a number
+    static const std::size_t TimeBlockSize = 1024;                                               //< Events per block of the time index
+
+    class Event;
+    class const_iterator;
+
+    /**
+     * @brief Appends an event, parsing and interning its fields
+     * @param url [in] the visited website
+     * @param device [in] the Device MAC-Address
+     * @param timestamp [in] time in seconds since UNIX epoch event took place
+     */
+    void append ( StringRef url, StringRef device, StringRef timestamp );
+
+    /**
+     * @brief Appends an owning #BrowsingEvent
+     */
+    void append ( const Qustodio::BrowsingEvent &event );
+
+    /**
+     * @brief Appends a #BrowsingEventView, copying the fields it references
+     */
+    void append ( const Qustodio::BrowsingEventView &event );
+
+    /**
+     * @brief Moves every event of #shard to the end of this store, keeping their order
+     *
+     * The columns are copied in bulk and the device ids of #shard are translated to this store. An empty store just
+     * takes over the columns of #shard.
+     * @param shard [in,out] the events filled by a single writer, left empty on return
+     */
+    void append ( EventStore &&shard );
+
+    /**
+     * @brief Copies every event of #segment to the end of this store, keeping their order
+     *
+     * Like the append of a shard, but #segment is left untouched, so it may be shared with readers.
+     * @param segment [in] the events to copy
+     */
+    void append ( const EventStore &segment );
+
+    /**
+     * @brief Reserves room for #events events of #urlBytes url characters in total
+     */
+    void reserve ( std::size_t events, std::size_t urlBytes );
+
+    /**
+     * @brief Removes every event and device
+     */
+    void clear ();
+
+    /**
+     * @brief Writes every event to a binary snapshot
+     *
+     * The snapshot is written next to #fileToWrite and renamed over it once complete.
+     * @param fileToWrite [in] the snapshot file
+     * @return false when the file can't be written
+     */
+    bool save ( const std::string &fileToWrite ) const;
+
+    /**
+     * @brief Replaces the events with the ones of a snapshot written by #save
+     *
+     * The columns reference the mapped file, which is kept alive by the store. The header, the size of every section
+     * and the offsets and device ids are checked before anything is replaced.
+     * @param fileToRead [in] the snapshot file
+     * @return false when the file can't be mapped or is not a valid snapshot, leaving the store untouched
+     */
+    bool load ( const std::string &fileToRead );
+
+    std::size_t size () const { return timestamps.size(); } //< Number of stored events
+    bool empty () const { return timestamps.empty(); }      //< True when there are no events
+
+    /**
+     * @brief The visited website of the event #index
+     */
+    StringRef url ( std::size_t index ) const
+    {
+      return StringRef( urlArena.data() + urlOffsets[index],
+                        static_cast< std::size_t >( urlOffsets[index + 1] - urlOffsets[index] ) );
+    }
+
+    std::int64_t timestamp ( std::size_t index ) const { return timestamps[index]; } //< Timestamp of the event #index
+    std::uint64_t mac ( std::size_t index ) const { return macs[index]; }            //< Packed MAC of the event #index
+    std::uint32_t deviceId ( std::size_t index ) const { return deviceIds[index]; }  //< Device id of the event #index
+    StringRef device ( std::size_t index ) const { return deviceName( deviceIds[index] ); } //< Device of the event #index
+
+    std::size_t deviceCount () const { return deviceNames.size(); }             //< Number of interned devices
+    StringRef deviceName ( std::uint32_t id ) const { return deviceNames[id]; } //< Device interned as #id, first spelling seen
+
+    /**
+     * @brief The events of the device #id, in increasing order
+     */
+    const Column< std::uint64_t > &deviceEvents ( std::uint32_t id ) const { return deviceEventLists[id]; }
+
+    /**
+     * @brief Looks a device up by its packed MAC-Address
+     * @param mac [in] the packed MAC-Address
+     * @param id [out] the id of the device
+     * @return false when no event of that device has been stored
+     */
+    bool findDevice ( std::uint64_t mac, std::uint32_t &id ) const { return macIndex.find( mac, id ); }
+
+    /**
+     * @brief Looks a device up by its MAC-Address in any spelling, or by its exact name when it is not a MAC-Address
+     * @param device [in] the device
+     * @param id [out] the id of the device
+     * @return false when no event of that device has been stored
+     */
+    bool findDevice ( StringRef device, std::uint32_t &id ) const;
+
+    std::size_t timeBlockCount () const { return blockMinimum.size(); } //< Number of blocks of the time index
+
+    /**
+     * @brief The largest valid timestamp of the store, read from the time index
+     * @return #InvalidTimestamp when no event has a valid timestamp
+     */
+    std::int64_t latestTimestamp () const;
+
+    /**
+     * @brief Appends to #blocks every block of the time index that may hold an event of the window [#from, #to)
+     *
+     * Block #b holds the events [b * #TimeBlockSize, (b + 1) * #TimeBlockSize). The events without a valid timestamp
+     * never fall in a window.
+     * @param from [in] first second of the window
+     * @param to [in] one past the last second of the window
+     * @param blocks [in,out] receives the candidate blocks, in increasing order
+     */
+    void timeBlocks ( std::int64_t from, std::int64_t to, std::vector< std::size_t > &blocks ) const;
+
+    /**
+     * @brief Bytes used by the columns, the url arena, the time index and the device dictionary
+     */
+    std::size_t memoryUsage () const;
+
+    /**
+     * @brief Materializes the event #index as an owning #BrowsingEvent
+     */
+    Qustodio::BrowsingEvent browsingEvent ( std::size_t index ) const;
+
+    Event operator[] ( std::size_t index ) const;
+
+    const_iterator begin () const;
+
+    const_iterator end () const;
+
+    /**
+     * @brief Packs a MAC-Address written as six hexadecimal pairs separated by `:` or `-`
+     * @param device [in] the textual MAC-Address
+     * @param mac [out] the 48 bits of the address
+     * @return false when #device is not a MAC-Address
+     */
+    static bool parseMac ( StringRef device, std::uint64_t &mac );
+
+    /**
+     * @brief Parses a timestamp in seconds since UNIX epoch
+     * @param timestamp [in] the decimal timestamp
+     * @param seconds [out] the parsed value
+     * @return false when #timestamp is not a decimal number
+     */
+    static bool parseTimestamp ( StringRef timestamp, std::int64_t &seconds );
+
+    private:
+    struct StringRefHash
+    {
+      std::size_t operator() ( const StringRef &string ) const;
+    };
+
+    /**
+     * @brief Returns the id of #device, interning it the first time
+     * @param device [in] the device as written in the log
+     * @param mac [in] #device packed, #InvalidMac when it is not a MAC-Address
+     */
+    std::uint32_t intern ( StringRef device, std::uint64_t mac );
+
+    /**
+     * @brief Updates the time index with the events from #first on
+     */
+    void indexTimestamps ( std::size_t first );
+
+    Column< std::int64_t > timestamps;                    //< Timestamp column
+    Column< std::uint64_t > macs;                         //< Packed MAC-Address column
+    Column< std::uint32_t > deviceIds;                    //< Interned device column
+    Column< std::uint64_t > urlOffsets = { 0 };           //< Url #i is [urlOffsets[i], urlOffsets[i + 1]) in #urlArena
+    Column< char > urlArena;                              //< Contiguous url bytes
+    std::deque< std::string > deviceNames;                //< Device dictionary, a deque keeps the keys below valid
+    std::unordered_map< StringRef, std::uint32_t, StringRefHash > deviceIndex; //< Device to id
+    MacTable macIndex;                                    //< Packed MAC-Address to id
+    std::vector< Column< std::uint64_t >> deviceEventLists; //< Events of every device id, may reference the #snapshot
+    std::vector< std::int64_t > blockMinimum;             //< Smallest valid timestamp of every block of the time index
+    std::vector< std::int64_t > blockMaximum;             //< Largest valid timestamp of every block of the time index
+    std::shared_ptr< const Qustodio::MappedFile > snapshot; //< The snapshot referenced by the columns, if any
+  };
+
+/*! \class EventStore::Event EventStore.hpp "EventStore.hpp"
+ *  \brief Accessor to one row of the #EventStore, with the getters of #BrowsingEvent.
+ */
+  class EventStore::Event
+  {
+    public:
+    Event ( const EventStore &store, std::size_t index )
+            : store( & store ), index( index )
+    { }
+
+    StringRef Url () const { return store->url( index ); }                 //< Getter to the visited website
+    StringRef Device () const { return store->device( index ); }           //< Getter to Device MAC-Address
+    std::int64_t Timestamp () const { return store->timestamp( index ); }  //< Getter to time since UNIX epoch
+    std::uint64_t Mac () const { return store->mac( index ); }             //< Getter to the packed MAC-Address
+    std::uint32_t DeviceId () const { return store->deviceId( index ); }   //< Getter to the interned device
+    std::size_t Index () const { return index; }                           //< Position in the store
+
+    private:
+    const EventStore *store; //< The owner of the columns
+    std::size_t index;       //< The row
+  };
+
+/*! \class EventStore::const_iterator EventStore.hpp "EventStore.hpp"
+ *  \brief Forward iterator over the rows of an #EventStore.
+ */
+  class EventStore::const_iterator
+  {
+    public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef EventStore::Event value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const EventStore::Event *pointer;
+    typedef EventStore::Event reference;
+
+    const_iterator ( const EventStore &store, std::size_t index )
+            : store( & store ), index( index )
+    { }
+
+    reference operator* () const { return EventStore::Event( * store, index ); }
+    const_iterator &operator++ () { ++index; return * this; }
+    const_iterator operator++ ( int ) { const_iterator previous( * this ); ++index; return previous; }
+    bool operator== ( const const_iterator &other ) const { return index == other.index; }
+    bool operator!= ( const const_iterator &other ) const { return index != other.index; }
+
+    private:
+    const EventStore *store; //< The iterated store
+    std::size_t index;       //< The current row
+  };
+
+  inline EventStore::Event EventStore::operator[] ( std::size_t index ) const
+  {
+    return Event( * this, index );
+  }
+
+  inline EventStore::const_iterator EventStore::begin () const
+  {
+    return const_iterator( * this, 0 );
+  }
+
+  inline EventStore::const_iterator EventStore::end () const
+  {
+    return const_iterator( * this, size() );
+  }
+
+} // namespace Qustodio
+
+#endif // EVENTSTORE_HPP
@@ -0,0 +1,108 @@
+/** @file
+ * @brief Event Version
+ *
+ * This file contains the immutable versions of the events published by the Common Storage Component
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref EventVersion_legal_note_sec
+ *
+ * @section EventVersion_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section EventVersion_intro_sec Introduction
+ *
+ * A version is a list of segments, every one an #EventStore that is never modified once published. Appending events
+ * builds a new version with one more segment, or with the last segments merged, and publishes it with a single atomic
+ * store of a std::shared_ptr, read-copy-update style. A reader loads the current version and scans its segments without
+ * any lock while the writers keep publishing newer ones. A segment is freed when the last version referencing it is
+ * released, so the reference counts act as the epochs that tell when nobody can see it anymore.
+ *
+ * @section EventVersion_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section EventVersion_install_sec Use
+ *
+ * @subsection EventVersion_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef EVENTVERSION_HPP
+#define EVENTVERSION_HPP
+
+#include "EventStore.hpp"
+#include "StringRef.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class EventVersion EventVersion.hpp "EventVersion.hpp"
+ *  \brief Immutable, numbered list of immutable #EventStore segments.
+ *
+ * The events are numbered across the segments in order, so event #i of the version is event
+ * `i - segmentStart( s )` of the segment #s holding it. Safe to share between threads.
+ */
+  class EventVersion
+  {
+    public:
+    typedef std::shared_ptr< const Qustodio::EventStore > Segment; //< A published segment
+
+    EventVersion () = default;
+
+    /**
+     * @brief Builds the version #number holding #segments, in order
+     */
+    EventVersion ( std::uint64_t number, std::vector< Segment > segments )
+            : number( number ), segments( std::move( segments ) )
+    {
+      std::size_t start = 0;
+      for ( auto &&segment: this->segments )
+      {
+        this->starts.push_back( start );
+        start += segment->size();
+      }
+      this->events = start;
+    }
+
+    std::uint64_t version () const { return number; }                          //< Grows with every publication
+    std::size_t size () const { return events; }                               //< Number of events of all the segments
+    bool empty () const { return 0 == events; }                                //< True when there are no events
+    std::size_t segmentCount () const { return segments.size(); }              //< Number of segments
+    const Segment &segment ( std::size_t index ) const { return segments[index]; }     //< The segment #index
+    std::size_t segmentStart ( std::size_t index ) const { return starts[index]; }     //< First event of the segment #index
+
+    /**
+     * @brief The segment holding the event #index
+     */
+    std::size_t segmentOf ( std::size_t index ) const
+    {
+      return static_cast< std::size_t >( std::upper_bound( starts.begin(), starts.end(), index ) - starts.begin() ) - 1;
+    }
+
+    /**
+     * @brief The visited website of the event #index
+     */
+    StringRef url ( std::size_t index ) const
+    {
+      const std::size_t s = segmentOf( index );
+      return segments[s]->url( index - starts[s] );
+    }
+
+    private:
+    std::uint64_t number = 0;            //< See #version
+    std::vector< Segment > segments;     //< The segments, oldest first
+    std::vector< std::size_t > starts;   //< First event of every segment
+    std::size_t events = 0;              //< See #size
+  };
+
+} // namespace Qustodio
+
+#endif // EVENTVERSION_HPP
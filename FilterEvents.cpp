@@ -27,42 +27,530 @@
 
 #include "FilterEvents.hpp"
 
+#include <algorithm>
 #include <iostream>
-#include <regex>
+#include <stdexcept>
 
-Qustodio::FilterEvents::FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent, const std::string &filter )
-: countFilteredElements(0), mCommonStorageComponent(commonStorageComponent), mFilter(filter)
+namespace
 {
-  this->browsingEvent = this->mCommonStorageComponent.BrowsingEvent();
+  const char *const filterStage = "filter"; //< The stage of the filters in ComposerPool::snapshot
+
+  /**
+   * @brief Position of the lowest bit set in #mask, which must not be 0
+   */
+  inline std::size_t lowestBit ( Qustodio::CategoryMatcher::Mask mask )
+  {
+#if defined( __GNUC__ )
+    return static_cast< std::size_t >( __builtin_ctzll( mask ) );
+#else
+    std::size_t bit = 0;
+    for ( ; 0 == ( mask & 1 ); mask >>= 1 )
+      ++bit;
+    return bit;
+#endif
+  }
+
+  /**
+   * @brief Calls #f( s, first, last ) for every segment #s of #version holding some of the events [#first, #last)
+   *
+   * The events are numbered across the segments as in EventVersion, the range given to #f is local to the segment.
+   */
+  template < class F >
+  void forEachSegment ( const Qustodio::EventVersion &version, std::size_t first, std::size_t last, F &&f )
+  {
+    if ( first >= last )
+      return;
+    for ( std::size_t s = version.segmentOf( first ); s < version.segmentCount() && version.segmentStart( s ) < last; ++s )
+    {
+      const std::size_t start = version.segmentStart( s );
+      const std::size_t end = start + version.segment( s )->size();
+      f( s, std::max( first, start ) - start, std::min( last, end ) - start );
+    }
+  }
+}
+
+Qustodio::FilterEvents::FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent, const std::string &filter,
+                                       RegexEngine engine )
+: mCommonStorageComponent(commonStorageComponent), mFilter(filter), mEngine(engine), countFilteredElements(0)
+{
+  this->loadEvents();
   if ( this->mFilter.length() > 0)
   {
     this->filterBadWords(this->mFilter);
   }
 }
 
+Qustodio::FilterEvents::FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent,
+                                       const std::vector< std::string > &keywords, bool caseInsensitive )
+: mCommonStorageComponent(commonStorageComponent), countFilteredElements(0)
+{
+  this->loadEvents();
+  this->filterKeywords( keywords, caseInsensitive );
+}
+
+Qustodio::FilterEvents::FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent,
+                                       const std::vector< Qustodio::CategoryMatcher::Category > &categories,
+                                       bool caseInsensitive )
+: mCommonStorageComponent(commonStorageComponent), countFilteredElements(0)
+{
+  this->loadEvents();
+  this->filterCategories( categories, caseInsensitive );
+}
+
+
+void Qustodio::FilterEvents::loadEvents ()
+{
+  // no lock, the writers keep publishing newer versions meanwhile
+  this->version = this->mCommonStorageComponent.Published();
+  this->mappedEvents = this->mCommonStorageComponent.MappedEvents();
+
+  // numbered as EventStore::append interns them, by MAC-Address whatever the spelling or else by name
+  std::map< std::uint64_t, std::uint32_t > byMac;
+  std::map< std::string, std::uint32_t > byName;
+  for ( std::size_t s = 0; s != this->version->segmentCount(); ++s )
+  {
+    const Qustodio::EventStore &segment = * this->version->segment( s );
+    std::vector< std::uint32_t > ids;
+    ids.reserve( segment.deviceCount() );
+    for ( std::uint32_t local = 0; local < segment.deviceCount(); ++local )
+    {
+      const Qustodio::StringRef name = segment.deviceName( local );
+      std::uint64_t mac = Qustodio::EventStore::InvalidMac;
+      if ( !Qustodio::EventStore::parseMac( name, mac ) )
+        mac = Qustodio::EventStore::InvalidMac;
+
+      auto found = Qustodio::EventStore::InvalidMac != mac ? byMac.find( mac ) : byMac.end();
+      std::uint32_t id = 0;
+      if ( found != byMac.end() )
+        id = found->second;
+      else
+      {
+        auto named = byName.emplace( std::string( name.data(), name.size() ),
+                                     static_cast< std::uint32_t >( this->deviceSegments.size() ) );
+        id = named.first->second;
+        if ( named.second )
+          this->deviceSegments.emplace_back();
+        if ( Qustodio::EventStore::InvalidMac != mac )
+          byMac.emplace( mac, id );
+      }
+      ids.push_back( id );
+      this->deviceSegments[id].emplace_back( s, local );
+    }
+    this->segmentDevices.push_back( std::move( ids ) );
+  }
+}
+
+Qustodio::StringRef Qustodio::FilterEvents::deviceName ( std::uint32_t id ) const
+{
+  const std::pair< std::size_t, std::uint32_t > &first = this->deviceSegments[id].front();
+  return this->version->segment( first.first )->deviceName( first.second );
+}
 
 void Qustodio::FilterEvents::filterBadWords ( const std::string &regexString )
 {
-  for ( auto &&result: * this->browsingEvent )
+  this->filterAllUrls( this->compileBadWords( regexString ) );
+}
+
+void Qustodio::FilterEvents::filterBadWords ( const std::string &regexString, std::int64_t from, std::int64_t to )
+{
+  this->filterWindowUrls( this->compileBadWords( regexString ), from, to );
+}
+
+void Qustodio::FilterEvents::filterDomains ( const std::vector< std::string > &domains )
+{
+  this->filterDomains( std::make_shared< const Qustodio::DomainBlocklist >( domains ) );
+}
+
+void Qustodio::FilterEvents::filterDomains ( const std::shared_ptr< const Qustodio::DomainBlocklist > &blocklist )
+{
+  this->domainBlocklist = blocklist;
+  this->filterAllUrls( & Qustodio::FilterEvents::filterDomainUrl );
+}
+
+void Qustodio::FilterEvents::filterDevices ( const std::string &regexString )
+{
+  const UrlFilter filter = this->compileBadWords( regexString );
+  const std::size_t devices = this->deviceCount();
+  this->mDeviceResults.assign( devices, DeviceResult() );
+
+  pool.parallel_for( 0, devices, 1,
+                     [ this, filter ] ( std::size_t id )
+                     {
+                       this->filterDeviceUrls( filter, static_cast< std::uint32_t >( id ) );
+                     } ).get();
+
+  std::size_t total = 0;
+  for ( auto &&result: this->mDeviceResults )
+    total += result.count;
+  this->countFilteredElement( total );
+}
+
+bool Qustodio::FilterEvents::filterDevice ( const std::string &regexString, Qustodio::StringRef device )
+{
+  std::uint32_t id = 0;
+  std::size_t s = 0;
+  for ( std::uint32_t local = 0; s != this->version->segmentCount(); ++s )
+    if ( this->version->segment( s )->findDevice( device, local ) )
+    {
+      id = this->segmentDevices[s][local];
+      break;
+    }
+  if ( s == this->version->segmentCount() )
+    return false;
+
+  const UrlFilter filter = this->compileBadWords( regexString );
+  if ( this->mDeviceResults.size() < this->deviceCount() )
+    this->mDeviceResults.resize( this->deviceCount() );
+
+  this->filterDeviceUrls( filter, id );
+  this->countFilteredElement( this->mDeviceResults[id].count );
+  return true;
+}
+
+Qustodio::ComposerPool &Qustodio::FilterEvents::Pool ()
+{
+  return this->pool;
+}
+
+const std::vector< Qustodio::FilterEvents::DeviceResult > &Qustodio::FilterEvents::deviceResults () const
+{
+  return this->mDeviceResults;
+}
+
+void Qustodio::FilterEvents::filterKeywords ( const std::vector< std::string > &keywords, bool caseInsensitive )
+{
+  this->filterAllUrls( this->compileKeywords( keywords, caseInsensitive ) );
+}
+
+void Qustodio::FilterEvents::filterCategories ( const std::vector< Qustodio::CategoryMatcher::Category > &categories,
+                                                bool caseInsensitive )
+{
+  this->filterCategories( std::make_shared< const Qustodio::CategoryMatcher >( categories, caseInsensitive ) );
+}
+
+void Qustodio::FilterEvents::filterCategories ( const std::shared_ptr< const Qustodio::CategoryMatcher > &matcher )
+{
+  this->categoryMatcher = matcher;
+
+  const Qustodio::EventVersion &version = * this->version;
+  const std::vector< Qustodio::BrowsingEventView > &views = * this->mappedEvents;
+  const std::size_t stored = version.size();
+  const std::size_t categories = matcher->categoryCount();
+  typedef std::vector< std::size_t > Counts; //< Events of every category, the last one of any category
+
+  // every chunk writes its own masks
+  this->mCategoryMasks.assign( stored + views.size(), 0 );
+  auto counts = pool.parallel_reduce( 0, stored + views.size(), urlGrainSize, Counts( categories + 1, 0 ),
+                                      [ this, &version, &views, stored, categories ] ( std::size_t first, std::size_t last )
+                                      {
+                                        Qustodio::ComposerPool::stage_timer timer( this->pool, filterStage );
+                                        const Qustodio::CategoryMatcher &categoryMatcher = * this->categoryMatcher;
+                                        Counts counts( categories + 1, 0 );
+                                        std::size_t bytes = 0;
+                                        auto classify = [ this, &categoryMatcher, &counts, &bytes, categories ]
+                                                ( std::size_t i, Qustodio::StringRef url )
+                                        {
+                                          bytes += url.size();
+                                          const Qustodio::CategoryMatcher::Mask mask = categoryMatcher.classify( url );
+                                          this->mCategoryMasks[i] = mask;
+                                          if ( 0 == mask )
+                                            return;
+                                          ++counts[categories];
+                                          for ( Qustodio::CategoryMatcher::Mask bits = mask; 0 != bits; bits &= bits - 1 )
+                                            ++counts[lowestBit( bits )];
+                                        };
+
+                                        forEachSegment( version, first, std::min( last, stored ),
+                                                        [ &version, &classify ] ( std::size_t s, std::size_t begin,
+                                                                                  std::size_t end )
+                                                        {
+                                                          const Qustodio::EventStore &store = * version.segment( s );
+                                                          const std::size_t base = version.segmentStart( s );
+                                                          for ( std::size_t i = begin; i < end; ++i )
+                                                            classify( base + i, store.url( i ) );
+                                                        } );
+                                        for ( std::size_t i = std::max( first, stored ); i < last; ++i )
+                                          classify( i, views[i - stored].Url() );
+                                        timer.add( last - first, bytes );
+                                        return counts;
+                                      },
+                                      [] ( Counts lhs, Counts rhs )
+                                      {
+                                        for ( std::size_t c = 0; c < lhs.size(); ++c )
+                                          lhs[c] += rhs[c];
+                                        return lhs;
+                                      } ).get();
+
+  this->mCategoryCounts.assign( counts.begin(), counts.end() - 1 );
+  this->countFilteredElement( counts.back() );
+}
+
+const std::vector< Qustodio::CategoryMatcher::Mask > &Qustodio::FilterEvents::categoryMasks () const
+{
+  return this->mCategoryMasks;
+}
+
+const std::vector< std::uint32_t > &Qustodio::FilterEvents::categoryCounts () const
+{
+  return this->mCategoryCounts;
+}
+
+void Qustodio::FilterEvents::filterStream ( Qustodio::BoundedChannel< Qustodio::EventStore > &channel,
+                                            const std::string &regexString, const FilteredCallback &onFiltered )
+{
+  try
+  {
+    const UrlFilter filter = this->compileBadWords( regexString );
+    Qustodio::EventStore batch;
+    while ( channel.pop( batch ) )
+      this->filterBatch( batch, filter, onFiltered );
+  }
+  catch ( ... )
+  {
+    channel.close();
+    throw;
+  }
+}
+
+Qustodio::FilterEvents::UrlFilter Qustodio::FilterEvents::compileBadWords ( const std::string &regexString )
+{
+  std::vector< std::string > keywords;
+  if ( Qustodio::KeywordMatcher::extractKeywords( regexString, keywords ) )
+    return this->compileKeywords( keywords, false );
+
+  if ( RegexEngine::Dfa == this->mEngine )
   {
-    pool.enqueue( & Qustodio::FilterEvents::filterUrl, this, result, regexString );
+    std::shared_ptr< const Qustodio::RegexDfa > &cached = this->regexDfaCache[regexString];
+    if ( !cached )
+      cached = std::make_shared< const Qustodio::RegexDfa >( regexString );
+    this->regexDfa = cached;
+    return & Qustodio::FilterEvents::filterDfaUrl;
   }
 
-  pool.wait_until_empty();
-  pool.wait_until_nothing_in_flight();
+  std::shared_ptr< const std::regex > &cached = this->regexCache[regexString];
+  if ( !cached )
+  {
+    try
+    {
+      cached = std::make_shared< const std::regex >( regexString );
+    }
+    catch ( const std::regex_error &error )
+    {
+      throw std::invalid_argument( error.what() );
+    }
+  }
+  this->regex = cached;
+  return & Qustodio::FilterEvents::filterUrl;
+}
+
+Qustodio::FilterEvents::UrlFilter
+Qustodio::FilterEvents::compileKeywords ( const std::vector< std::string > &keywords, bool caseInsensitive )
+{
+  if ( keywords.size() <= simdKeywordLimit )
+  {
+    this->substringScanner = std::make_shared< const Qustodio::SubstringScanner >( keywords, caseInsensitive );
+    this->keywordMatcher.reset();
+  }
+  else
+  {
+    this->keywordMatcher = std::make_shared< const Qustodio::KeywordMatcher >( keywords, caseInsensitive );
+    this->substringScanner.reset();
+  }
+
+  return & Qustodio::FilterEvents::filterKeywordUrl;
+}
+
+void Qustodio::FilterEvents::filterAllUrls ( UrlFilter filter )
+{
+  const Qustodio::EventVersion &version = * this->version;
+  const std::vector< Qustodio::BrowsingEventView > &views = * this->mappedEvents;
+  const std::size_t stored = version.size();
+
+  // one task per worker, each one counting its chunks in its own slot
+  AggregateSlots slots( this->pool, this->emptySlot( filter ) );
+  pool.parallel_for_chunks( 0, stored + views.size(), urlGrainSize,
+                            [ this, filter, &slots, &version, &views, stored ] ( std::size_t first, std::size_t last )
+                            {
+                              Qustodio::ComposerPool::stage_timer timer( this->pool, filterStage );
+                              AggregateSlot &slot = slots.local();
+                              std::size_t bytes = 0;
+                              forEachSegment( version, first, std::min( last, stored ),
+                                              [ this, filter, &slot, &bytes, &version ] ( std::size_t s,
+                                                                                          std::size_t begin,
+                                                                                          std::size_t end )
+                              {
+                                const Qustodio::EventStore &store = * version.segment( s );
+                                const std::vector< std::uint32_t > &devices = this->segmentDevices[s];
+                                const std::size_t base = version.segmentStart( s );
+                                for ( std::size_t i = begin; i < end; ++i )
+                                {
+                                  const Qustodio::StringRef url = store.url( i );
+                                  bytes += url.size();
+                                  if ( ( this->*filter )( url ) )
+                                    this->countMatch( slot, base + i, url, devices[store.deviceId( i )],
+                                                      store.timestamp( i ) );
+                                }
+                              } );
+
+                              for ( std::size_t i = std::max( first, stored ); i < last; ++i )
+                              {
+                                const Qustodio::BrowsingEventView &view = views[i - stored];
+                                bytes += view.Url().size();
+                                if ( ( this->*filter )( view.Url() ) )
+                                {
+                                  std::int64_t seconds = Qustodio::EventStore::InvalidTimestamp;
+                                  if ( !Qustodio::EventStore::parseTimestamp( view.Timestamp(), seconds ) )
+                                    seconds = Qustodio::EventStore::InvalidTimestamp;
+                                  this->countMatch( slot, i, view.Url(), NoDevice, seconds );
+                                }
+                              }
+                              timer.add( last - first, bytes );
+                            } ).get();
+
+  this->reduceAggregates( filter, slots );
+}
+
+void Qustodio::FilterEvents::filterWindowUrls ( UrlFilter filter, std::int64_t from, std::int64_t to )
+{
+  const Qustodio::EventVersion &version = * this->version;
+  const std::vector< Qustodio::BrowsingEventView > &views = * this->mappedEvents;
+  const std::size_t blockSize = Qustodio::EventStore::TimeBlockSize;
+
+  // the candidate blocks of every segment, as the segment and the block within it
+  std::vector< std::pair< std::size_t, std::size_t >> blocks;
+  std::vector< std::size_t > segmentBlocks;
+  for ( std::size_t s = 0; s != version.segmentCount(); ++s )
+  {
+    segmentBlocks.clear();
+    version.segment( s )->timeBlocks( from, to, segmentBlocks );
+    for ( std::size_t block: segmentBlocks )
+      blocks.emplace_back( s, block );
+  }
+  // the views keep their timestamps as text, every one of them is checked
+  const std::size_t viewBlocks = ( views.size() + blockSize - 1 ) / blockSize;
+
+  AggregateSlots slots( this->pool, this->emptySlot( filter ) );
+  pool.parallel_for_chunks( 0, blocks.size() + viewBlocks, 1,
+                            [ this, filter, from, to, blockSize, &slots, &version, &views, &blocks ]
+                                    ( std::size_t first, std::size_t last )
+                            {
+                              Qustodio::ComposerPool::stage_timer timer( this->pool, filterStage );
+                              AggregateSlot &slot = slots.local();
+                              for ( std::size_t item = first; item < last; ++item )
+                              {
+                                if ( item < blocks.size() )
+                                {
+                                  const std::size_t s = blocks[item].first;
+                                  const Qustodio::EventStore &store = * version.segment( s );
+                                  const std::vector< std::uint32_t > &devices = this->segmentDevices[s];
+                                  const std::size_t base = version.segmentStart( s );
+                                  const std::size_t begin = blocks[item].second * blockSize;
+                                  const std::size_t end = std::min( begin + blockSize, store.size() );
+                                  timer.add( end - begin );
+                                  for ( std::size_t i = begin; i < end; ++i )
+                                  {
+                                    const std::int64_t seconds = store.timestamp( i );
+                                    if ( seconds >= from && seconds < to
+                                         && Qustodio::EventStore::InvalidTimestamp != seconds
+                                         && ( this->*filter )( store.url( i ) ) )
+                                      this->countMatch( slot, base + i, store.url( i ), devices[store.deviceId( i )],
+                                                        seconds );
+                                  }
+                                  continue;
+                                }
+
+                                const std::size_t begin = ( item - blocks.size() ) * blockSize;
+                                const std::size_t end = std::min( begin + blockSize, views.size() );
+                                timer.add( end - begin );
+                                for ( std::size_t i = begin; i < end; ++i )
+                                {
+                                  std::int64_t seconds = 0;
+                                  if ( Qustodio::EventStore::parseTimestamp( views[i].Timestamp(), seconds )
+                                       && seconds >= from && seconds < to
+                                       && ( this->*filter )( views[i].Url() ) )
+                                    this->countMatch( slot, version.size() + i, views[i].Url(), NoDevice,
+                                                      seconds );
+                                }
+                              }
+                            } ).get();
+
+  this->reduceAggregates( filter, slots );
+}
+
+void Qustodio::FilterEvents::filterDeviceUrls ( UrlFilter filter, std::uint32_t id )
+{
+  Qustodio::ComposerPool::stage_timer timer( this->pool, filterStage );
+  DeviceResult result;
+
+  // the segments are in order, so are the events
+  for ( auto &&segment: this->deviceSegments[id] )
+  {
+    const Qustodio::EventStore &store = * this->version->segment( segment.first );
+    const std::uint64_t base = this->version->segmentStart( segment.first );
+    const Qustodio::Column< std::uint64_t > &events = store.deviceEvents( segment.second );
+    for ( std::uint64_t event: events )
+    {
+      if ( ( this->*filter )( store.url( static_cast< std::size_t >( event ) ) ) )
+        result.matches.push_back( base + event );
+    }
+    timer.add( events.size() );
+  }
+  result.count = static_cast< std::uint32_t >( result.matches.size() );
+
+  // every task writes its own entry
+  this->mDeviceResults[id] = std::move( result );
+}
+
+void Qustodio::FilterEvents::filterBatch ( const Qustodio::EventStore &batch, UrlFilter filter,
+                                           const FilteredCallback &onFiltered )
+{
+  if ( !onFiltered )
+  {
+    auto matches = pool.parallel_reduce( 0, batch.size(), urlGrainSize, std::size_t( 0 ),
+                                         [ this, filter, &batch ] ( std::size_t first, std::size_t last )
+                                         {
+                                           Qustodio::ComposerPool::stage_timer timer( this->pool, filterStage );
+                                           std::size_t count = 0;
+                                           for ( std::size_t i = first; i < last; ++i )
+                                             if ( ( this->*filter )( batch.url( i ) ) )
+                                               ++count;
+                                           timer.add( last - first );
+                                           return count;
+                                         },
+                                         [] ( std::size_t lhs, std::size_t rhs ) { return lhs + rhs; } );
+    this->countFilteredElement( matches.get() );
+    return;
+  }
+
+  // the callback sees the flagged events in order, on this thread
+  std::vector< char > flagged( batch.size(), 0 );
+  pool.parallel_for( 0, batch.size(), urlGrainSize,
+                     [ this, filter, &batch, &flagged ] ( std::size_t i )
+                     {
+                       flagged[i] = ( this->*filter )( batch.url( i ) );
+                     } ).get();
+
+  std::size_t matches = 0;
+  for ( std::size_t i = 0; i < flagged.size(); ++i )
+  {
+    if ( flagged[i] )
+    {
+      onFiltered( batch[i] );
+      ++matches;
+    }
+  }
+  this->countFilteredElement( matches );
 }
 
 void Qustodio::FilterEvents::showFilteredResultsCount ( void )
 {
-  std::cout << this->countFilteredElements << std::endl;
+  std::cout << this->countFilteredElements.load() << std::endl;
 }
 
-void Qustodio::FilterEvents::filterUrl ( Qustodio::BrowsingEvent &element, const std::string &regexString )
+bool Qustodio::FilterEvents::filterUrl ( Qustodio::StringRef url ) const
 {
-  std::regex strRegex( regexString );
-  std::smatch resultUrl;
-  std::string url = element.Url();
-  std::regex_search( url, resultUrl, strRegex );
+  std::cmatch resultUrl;
+  std::regex_search( url.begin(), url.end(), resultUrl, * this->regex );
 
   if ( resultUrl[1].length() > 0 )
   {
@@ -70,10 +558,135 @@ void Qustodio::FilterEvents::filterUrl ( Qustodio::BrowsingEvent &element, const
 #if SHOW_INTERMEDIATE
     std::cout << "Found filtered words!" << std::endl;
 #endif
+    return true;
+  }
+  return false;
+}
+
+bool Qustodio::FilterEvents::filterDfaUrl ( Qustodio::StringRef url ) const
+{
+  if ( this->regexDfa->matches( url ) )
+  {
+#if SHOW_INTERMEDIATE
+    std::cout << "Found filtered words!" << std::endl;
+#endif
+    return true;
+  }
+  return false;
+}
+
+bool Qustodio::FilterEvents::filterKeywordUrl ( Qustodio::StringRef url ) const
+{
+  const bool found = this->substringScanner ? this->substringScanner->matches( url )
+                                             : this->keywordMatcher->matches( url );
+  if ( found )
+  {
+#if SHOW_INTERMEDIATE
+    std::cout << "Found filtered words!" << std::endl;
+#endif
+    return true;
+  }
+  return false;
+}
+
+bool Qustodio::FilterEvents::filterDomainUrl ( Qustodio::StringRef url ) const
+{
+  if ( this->domainBlocklist->matches( url ) )
+  {
+#if SHOW_INTERMEDIATE
+    std::cout << "Found blocked domain!" << std::endl;
+#endif
+    return true;
+  }
+  return false;
+}
+
+uint32_t Qustodio::FilterEvents::filteredResultsCount ()
+{
+  return this->countFilteredElements.load();
+}
+
+void Qustodio::FilterEvents::countFilteredElement ( std::size_t amount )
+{
+  this->countFilteredElements.fetch_add( static_cast< uint32_t >( amount ) );
+}
+
+void Qustodio::FilterEvents::FilterAggregates::merge ( const FilterAggregates &other )
+{
+  this->matches += other.matches;
+  for ( std::size_t k = 0; k < other.keywords.size(); ++k )
+    this->keywords[k] += other.keywords[k];
+  for ( std::size_t d = 0; d < other.devices.size(); ++d )
+    this->devices[d] += other.devices[d];
+  for ( auto &&hour: other.hours )
+    this->hours[hour.first] += hour.second;
+}
+
+Qustodio::FilterEvents::AggregateSlot Qustodio::FilterEvents::emptySlot ( UrlFilter filter ) const
+{
+  AggregateSlot slot;
+  if ( & Qustodio::FilterEvents::filterKeywordUrl == filter )
+  {
+    const std::size_t keywords = this->substringScanner ? this->substringScanner->keywordCount()
+                                                        : this->keywordMatcher->keywordCount();
+    slot.values.keywords.assign( keywords, 0 );
+    if ( this->keywordMatcher )
+      slot.counted.assign( keywords, 0 );
+  }
+  slot.values.devices.assign( this->deviceCount(), 0 );
+  return slot;
+}
+
+void Qustodio::FilterEvents::countMatch ( AggregateSlot &slot, std::size_t index, Qustodio::StringRef url,
+                                          std::uint32_t device, std::int64_t seconds ) const
+{
+  FilterAggregates &values = slot.values;
+  ++values.matches;
+
+  if ( NoDevice != device )
+    ++values.devices[device];
+
+  if ( Qustodio::EventStore::InvalidTimestamp != seconds )
+  {
+    std::int64_t hour = seconds - seconds % 3600;
+    if ( seconds % 3600 < 0 )
+      hour -= 3600;
+    ++values.hours[hour];
+  }
+
+  if ( values.keywords.empty() )
+    return;
+
+  // only the flagged urls are scanned again, so this costs nothing to the events that don't match
+  if ( this->substringScanner )
+  {
+    for ( std::size_t k = 0; k < values.keywords.size(); ++k )
+      if ( this->substringScanner->matchesKeyword( url, k ) )
+        ++values.keywords[k];
+    return;
+  }
+
+  this->keywordMatcher->forEachMatch( url, [ &slot, index ] ( std::size_t keyword, std::size_t )
+  {
+    // a keyword found twice in the same url counts once
+    if ( slot.counted[keyword] != index + 1 )
     {
-      std::lock_guard< std::mutex > lock( this->browsingEventMutex );
-      ++this->countFilteredElements;
+      slot.counted[keyword] = index + 1;
+      ++slot.values.keywords[keyword];
     }
-  }
-  std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+  } );
+}
+
+void Qustodio::FilterEvents::reduceAggregates ( UrlFilter filter, AggregateSlots &slots )
+{
+  FilterAggregates total = this->emptySlot( filter ).values;
+  slots.for_each( [ &total ] ( const AggregateSlot &slot ) { total.merge( slot.values ); } );
+
+  this->mAggregates = std::move( total );
+  this->countFilteredElement( this->mAggregates.matches );
+}
+
+const Qustodio::FilterEvents::FilterAggregates &Qustodio::FilterEvents::aggregates () const
+{
+  return this->mAggregates;
 }
\ No newline at end of file
@@ -29,43 +29,370 @@
 #define FILTEREVENTS_HPP
 
 #include "CommonStorageComponent.hpp"
+#include "BoundedChannel.hpp"
 #include "BrowsingEvent.hpp"
+#include "CategoryMatcher.hpp"
+#include "DomainBlocklist.hpp"
+#include "KeywordMatcher.hpp"
+#include "RegexDfa.hpp"
+#include "StringRef.hpp"
+#include "SubstringScanner.hpp"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
 
 namespace Qustodio
 {
   class FilterEvents
   {
     public:
-    FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent, const std::string &filter = 0 );
+    /**
+     * @brief Engines able to run the regular expressions of #filterBadWords
+     */
+    enum class RegexEngine
+    {
+      Std, //< std::regex, the whole ECMAScript syntax, counts the events whose first group matched
+      Dfa  //< #RegexDfa, linear time on a subset of the syntax, counts the events matched anywhere
+    };
+
+    /**
+     * @brief Flagged events of a single device
+     */
+    struct DeviceResult
+    {
+      std::uint32_t count = 0;             //< Number of flagged events
+      std::vector< std::uint64_t > matches; //< The flagged events, positions in the #EventVersion in increasing order
+    };
+
+    /**
+     * @brief What the events flagged by the last filter over all the captured events have in common
+     *
+     * Filled by #filterBadWords, #filterKeywords and #filterDomains. Every worker adds up its matches in its own slot,
+     * see ComposerPool::worker_local, and the slots are merged once the filter completes.
+     */
+    struct FilterAggregates
+    {
+      std::uint64_t matches = 0;                     //< Number of flagged events
+      std::vector< std::uint64_t > keywords;         //< Flagged events holding every keyword, when the filter is a keyword list
+      std::vector< std::uint64_t > devices;          //< Flagged events of every device id of #deviceName
+      std::map< std::int64_t, std::uint64_t > hours; //< Flagged events by the first second of their hour, valid timestamps only
+
+      /**
+       * @brief Adds the counts of #other, of the same filter
+       */
+      void merge ( const FilterAggregates &other );
+    };
+
+    /**
+     * @brief Receives every event flagged by #filterStream, in input order
+     */
+    typedef std::function< void ( const Qustodio::EventStore::Event & ) > FilteredCallback;
+
+    FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent, const std::string &filter = "",
+                   RegexEngine engine = RegexEngine::Std );
+
+    /**
+     * @brief Builds the filter and runs #filterKeywords with #keywords
+     */
+    FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent,
+                   const std::vector< std::string > &keywords, bool caseInsensitive = false );
+
+    /**
+     * @brief Builds the filter and runs #filterCategories with #categories
+     */
+    FilterEvents ( Qustodio::CommonStorageComponent &commonStorageComponent,
+                   const std::vector< Qustodio::CategoryMatcher::Category > &categories,
+                   bool caseInsensitive = false );
 
     /**
      * @brief Filters all captured events using the #regexString filter
+     *
+     * A filter that is only an alternation of literals, like `.*(porn|xxx).*`, runs through #filterKeywords,
+     * any other regular expression runs through the #RegexEngine chosen at construction. The expression is
+     * compiled once, cached, and shared by every worker.
      * @param regexString [in] the filter
+     * @throw std::invalid_argument when #regexString is not valid for the engine
      */
     void filterBadWords ( const std::string &regexString );
 
+    /**
+     * @brief Filters the captured events of the time window [#from, #to) using the #regexString filter
+     *
+     * Only the blocks of the time index of every segment that overlap the window are visited, see
+     * EventStore::timeBlocks. The events without a valid timestamp are never counted.
+     * @param regexString [in] the filter, as in #filterBadWords
+     * @param from [in] first second of the window, since UNIX epoch
+     * @param to [in] one past the last second of the window
+     * @throw std::invalid_argument when #regexString is not valid for the engine
+     */
+    void filterBadWords ( const std::string &regexString, std::int64_t from, std::int64_t to );
+
+    /**
+     * @brief Filters all captured events whose host is one of the #domains or a subdomain of them
+     *
+     * Builds a #DomainBlocklist, see there for the normalization of the hosts and the domains.
+     * @param domains [in] the blocked domains
+     */
+    void filterDomains ( const std::vector< std::string > &domains );
+
+    /**
+     * @brief Filters all captured events with a prebuilt #blocklist, shared with other filters
+     */
+    void filterDomains ( const std::shared_ptr< const Qustodio::DomainBlocklist > &blocklist );
+
+    /**
+     * @brief Filters the captured events of every device using the #regexString filter
+     *
+     * Walks the per device event lists of the segments, one device per task, and fills #deviceResults. The global
+     * count grows by the total as with #filterBadWords. The mapped views are not indexed and are not visited.
+     * @param regexString [in] the filter, as in #filterBadWords
+     * @throw std::invalid_argument when #regexString is not valid for the engine
+     */
+    void filterDevices ( const std::string &regexString );
+
+    /**
+     * @brief Filters only the captured events of #device using the #regexString filter
+     *
+     * Only the event list of #device is visited, its entry of #deviceResults is replaced.
+     * @param regexString [in] the filter, as in #filterBadWords
+     * @param device [in] the device, a MAC-Address in any spelling or the exact name of the device
+     * @return false when no segment holds an event of #device
+     * @throw std::invalid_argument when #regexString is not valid for the engine
+     */
+    bool filterDevice ( const std::string &regexString, Qustodio::StringRef device );
+
+    /**
+     * @brief The aggregates of the last #filterBadWords, #filterKeywords or #filterDomains
+     *
+     * The keywords are counted in the order given to #filterKeywords, or to the alternation of #filterBadWords, without
+     * the empty ones. The mapped views have no device id and only count in #FilterAggregates::hours.
+     */
+    const FilterAggregates &aggregates () const;
+
+    /**
+     * @brief The results of #filterDevices and #filterDevice, indexed by the device ids of #deviceName
+     */
+    const std::vector< DeviceResult > &deviceResults () const;
+
+    /**
+     * @brief The device #id of #deviceResults and FilterAggregates::devices
+     *
+     * The devices of all the segments of the #EventVersion are numbered once, in the order the merged store of
+     * CommonStorageComponent::Events numbers them.
+     */
+    Qustodio::StringRef deviceName ( std::uint32_t id ) const;
+
+    std::size_t deviceCount () const { return deviceSegments.size(); } //< Number of devices of the #EventVersion
+
+    /**
+     * @brief Filters all captured events whose url contains any of the #keywords
+     *
+     * Up to #simdKeywordLimit keywords are looked for with the SIMD #SubstringScanner, longer lists are compiled
+     * into a #KeywordMatcher. Either way the engine is built once and shared by every worker.
+     * @param keywords [in] the blocklist
+     * @param caseInsensitive [in] true to ignore the case of ASCII letters
+     */
+    void filterKeywords ( const std::vector< std::string > &keywords, bool caseInsensitive = false );
+
+    /**
+     * @brief Classifies all captured events in every category of #categories with a single scan
+     *
+     * Builds a #CategoryMatcher, see there for how the categories are compiled together.
+     * @param categories [in] the named keyword lists, at most CategoryMatcher::MaxCategories
+     * @param caseInsensitive [in] true to ignore the case of ASCII letters
+     * @throw std::invalid_argument when there are too many categories
+     */
+    void filterCategories ( const std::vector< Qustodio::CategoryMatcher::Category > &categories,
+                            bool caseInsensitive = false );
+
+    /**
+     * @brief Classifies all captured events with a prebuilt #matcher, shared with other filters
+     *
+     * Fills #categoryMasks and #categoryCounts. The global count grows by the events that belong to any category.
+     */
+    void filterCategories ( const std::shared_ptr< const Qustodio::CategoryMatcher > &matcher );
+
+    /**
+     * @brief The categories of every event after #filterCategories, the events of the #EventVersion first and then the
+     * mapped ones
+     */
+    const std::vector< Qustodio::CategoryMatcher::Mask > &categoryMasks () const;
+
+    /**
+     * @brief The number of events of every category after #filterCategories, by category index
+     */
+    const std::vector< std::uint32_t > &categoryCounts () const;
+
+    /**
+     * @brief Filters the batches popped from #channel with the #regexString filter until it is closed
+     *
+     * Runs concurrently with the producer, usually CommonStorageComponent::streamFromFile, and counts the events of
+     * every batch as soon as it arrives. The filter is chosen as in #filterBadWords. The channel is closed on error
+     * so the producer never waits forever.
+     * @param channel [in,out] the batches of events to filter
+     * @param regexString [in] the filter
+     * @param onFiltered [in] optional, called with every flagged event once its batch is filtered
+     * @throw std::invalid_argument when #regexString is not valid for the engine
+     */
+    void filterStream ( Qustodio::BoundedChannel< Qustodio::EventStore > &channel, const std::string &regexString,
+                        const FilteredCallback &onFiltered = FilteredCallback() );
+
     /**
      * @brief Show the number of filtered results
      */
     void showFilteredResultsCount ( void );
+
+    /**
+     * @brief The number of filtered results so far, safe to call while #filterStream runs
+     */
+    uint32_t filteredResultsCount ();
+
+    /**
+     * @brief The thread pool of the filters, for its ComposerPool::snapshot and ComposerPool::dump_statistics
+     *
+     * Every filter records the urls and bytes it visits as the "filter" stage of the pool.
+     */
+    Qustodio::ComposerPool &Pool ();
     private:
+    typedef bool ( Qustodio::FilterEvents::*UrlFilter ) ( Qustodio::StringRef ) const; //< One of the url filters
+
+    static const std::uint32_t NoDevice = ~std::uint32_t( 0 ); //< The device id of the mapped views
 
     /**
-     * @brief Given a #regexString, filters all #BrowsingEvent to match the filter
-     * @param element [in] a #BrowsingElement
-     * @param regexString [in] the filter
+     * @brief The #FilterAggregates of a single worker
+     */
+    struct AggregateSlot
+    {
+      FilterAggregates values;             //< The matches of the worker
+      std::vector< std::uint64_t > counted; //< One past the last event counted for every keyword of the #keywordMatcher
+    };
+
+    typedef Qustodio::ComposerPool::worker_local< AggregateSlot > AggregateSlots; //< The slots of every worker
+
+    /**
+     * @brief An empty slot sized for the keywords of #filter and the devices of the #EventVersion
+     */
+    AggregateSlot emptySlot ( UrlFilter filter ) const;
+
+    /**
+     * @brief Counts the flagged event #index in the #slot of the current worker
+     * @param slot [in,out] the slot of the current worker
+     * @param index [in] the event, unique among the events of the filter
+     * @param url [in] the url of the event
+     * @param device [in] the device id of the event, #NoDevice for the mapped views
+     * @param seconds [in] the timestamp of the event, EventStore::InvalidTimestamp when missing
+     */
+    void countMatch ( AggregateSlot &slot, std::size_t index, Qustodio::StringRef url, std::uint32_t device,
+                      std::int64_t seconds ) const;
+
+    /**
+     * @brief Merges the #slots into #mAggregates and counts their matches
+     */
+    void reduceAggregates ( UrlFilter filter, AggregateSlots &slots );
+
+    /**
+     * @brief Takes the current #EventVersion and mapped views of the component and numbers their devices
+     */
+    void loadEvents ();
+
+    /**
+     * @brief Compiles, or takes from the caches, the engine of #regexString
+     * @return the url filter running it
+     * @throw std::invalid_argument when #regexString is not valid for the engine
+     */
+    UrlFilter compileBadWords ( const std::string &regexString );
+
+    /**
+     * @brief Builds the #substringScanner or the #keywordMatcher of #keywords
+     * @return the url filter running it
      */
-    void filterUrl ( Qustodio::BrowsingEvent &element, const std::string &regexString);
+    UrlFilter compileKeywords ( const std::vector< std::string > &keywords, bool caseInsensitive );
+
+    /**
+     * @brief Filters the url of a #BrowsingEvent with the compiled #regex
+     * @param url [in] the url of a #BrowsingElement, owned by the #CommonStorageComponent
+     * @return true when the url has to be filtered
+     */
+    bool filterUrl ( Qustodio::StringRef url ) const;
+
+    /**
+     * @brief Filters the url of a #BrowsingEvent with the compiled #regexDfa
+     * @param url [in] the url of a #BrowsingElement, owned by the #CommonStorageComponent
+     * @return true when the url has to be filtered
+     */
+    bool filterDfaUrl ( Qustodio::StringRef url ) const;
+
+    /**
+     * @brief Runs #filter over the url of every captured event, in chunks of #urlGrainSize, and counts the matches
+     */
+    void filterAllUrls ( UrlFilter filter );
+
+    /**
+     * @brief Runs #filter over the url of every captured event of the window [#from, #to) and counts the matches
+     */
+    void filterWindowUrls ( UrlFilter filter, std::int64_t from, std::int64_t to );
+
+    /**
+     * @brief Runs #filter over the events of the device #id and stores them in #deviceResults
+     */
+    void filterDeviceUrls ( UrlFilter filter, std::uint32_t id );
+
+    /**
+     * @brief Runs #filter over the urls of #batch and counts the matches
+     * @param onFiltered [in] when set, called with every flagged event in order
+     */
+    void filterBatch ( const Qustodio::EventStore &batch, UrlFilter filter, const FilteredCallback &onFiltered );
+
+    /**
+     * @brief Filters the url of a #BrowsingEvent with the #substringScanner or the #keywordMatcher
+     * @param url [in] the url of a #BrowsingElement, owned by the #CommonStorageComponent
+     * @return true when the url has to be filtered
+     */
+    bool filterKeywordUrl ( Qustodio::StringRef url ) const;
+
+    /**
+     * @brief Filters the url of a #BrowsingEvent with the #domainBlocklist
+     * @param url [in] the url of a #BrowsingElement, owned by the #CommonStorageComponent
+     * @return true when the url has to be filtered
+     */
+    bool filterDomainUrl ( Qustodio::StringRef url ) const;
+
+    /**
+     * @brief Counts #amount more filtered elements
+     */
+    void countFilteredElement ( std::size_t amount );
+
     ComposerPool pool;             //< The thread pool to filter the Events
-    std::mutex browsingEventMutex; //< The synchronize mechanism to make insertions sequentially
     Qustodio::CommonStorageComponent &mCommonStorageComponent; //< Access to the CommonStorageComponent
     std::string mFilter; //< The filter used
-    uint32_t countFilteredElements;//< The amount of filtered elements
+    RegexEngine mEngine = RegexEngine::Std; //< The engine of the regular expressions
+    std::atomic< uint32_t > countFilteredElements;//< The amount of filtered elements
+
+    std::shared_ptr< const Qustodio::EventVersion > version; //< The segments of #BrowsingEvent, scanned in place
+    std::vector< std::vector< std::uint32_t >> segmentDevices; //< Device id of every device of every segment
+    std::vector< std::vector< std::pair< std::size_t, std::uint32_t >>> deviceSegments; //< Segment and id of every device
+    std::shared_ptr < const std::vector< Qustodio::BrowsingEventView>> mappedEvents; //< The vector of #BrowsingEventView
+    std::shared_ptr< const Qustodio::KeywordMatcher > keywordMatcher; //< The compiled keywords of #filterKeywords
+    std::shared_ptr< const Qustodio::SubstringScanner > substringScanner; //< The short keyword lists of #filterKeywords
+    std::shared_ptr< const Qustodio::DomainBlocklist > domainBlocklist; //< The blocked domains of #filterDomains
+    std::shared_ptr< const Qustodio::CategoryMatcher > categoryMatcher; //< The categories of #filterCategories
+    std::shared_ptr< const std::regex > regex; //< The compiled expression of #filterBadWords
+    std::shared_ptr< const Qustodio::RegexDfa > regexDfa; //< The compiled expression of #filterBadWords
+
+    std::vector< DeviceResult > mDeviceResults; //< The results of #filterDevices, by device id
+    FilterAggregates mAggregates; //< The results of the last filter over all the events
+    std::vector< Qustodio::CategoryMatcher::Mask > mCategoryMasks; //< The results of #filterCategories, by event
+    std::vector< std::uint32_t > mCategoryCounts; //< The results of #filterCategories, by category
+    std::map< std::string, std::shared_ptr< const std::regex >> regexCache; //< Expressions already compiled
+    std::map< std::string, std::shared_ptr< const Qustodio::RegexDfa >> regexDfaCache; //< Automata already built
 
-    // Can't be auto!
-    std::shared_ptr <std::vector< Qustodio::BrowsingEvent>> browsingEvent =
-            std::make_shared < std::vector < Qustodio::BrowsingEvent >> (
-                    std::vector< Qustodio::BrowsingEvent >() ); //< The vector of #BrowsingEvent
+    static const std::size_t simdKeywordLimit = 8; //< Longest keyword list scanned without the automaton
+    static const std::size_t urlGrainSize = 1024;  //< Smallest chunk of urls filtered by a single task
   };
 } // namespace Qustodio
 
@@ -0,0 +1,147 @@
+#include "KeywordMatcher.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <queue>
+
+const std::uint32_t Qustodio::KeywordMatcher::AcceptingFlag;
+const std::uint32_t Qustodio::KeywordMatcher::StateMask;
+
+Qustodio::KeywordMatcher::KeywordMatcher ()
+        : KeywordMatcher( std::vector< std::string >() )
+{ }
+
+Qustodio::KeywordMatcher::KeywordMatcher ( const std::vector< std::string > &keywords, bool caseInsensitive )
+{
+  for ( auto &&keyword: keywords )
+  {
+    if ( keyword.empty() )
+      continue;
+    this->keywords.push_back( keyword );
+    if ( caseInsensitive )
+      for ( auto &&character: this->keywords.back() )
+        character = static_cast< char >( std::tolower( static_cast< unsigned char >( character ) ) );
+  }
+
+  // every byte used by a keyword gets its own column, the rest share the column 0
+  this->byteClass.fill( 0 );
+  for ( auto &&keyword: this->keywords )
+    for ( char character: keyword )
+    {
+      const unsigned char byte = static_cast< unsigned char >( character );
+      if ( 0 == this->byteClass[byte] )
+        this->byteClass[byte] = static_cast< std::uint16_t >( this->alphabetSize++ );
+    }
+  if ( caseInsensitive )
+    for ( int upper = 'A'; upper <= 'Z'; ++upper )
+      this->byteClass[upper] = this->byteClass[std::tolower( upper )];
+
+  const std::size_t alphabet = this->alphabetSize;
+  const std::uint32_t missing = ~std::uint32_t( 0 );
+
+  // trie of the keywords
+  this->transitions.assign( alphabet, missing );
+  std::vector< std::vector< std::uint32_t > > stateOutputs( 1 );
+  for ( std::uint32_t index = 0; index < this->keywords.size(); ++index )
+  {
+    std::uint32_t state = 0;
+    for ( char character: this->keywords[index] )
+    {
+      const std::size_t cell = state * alphabet + this->byteClass[static_cast< unsigned char >( character )];
+      if ( missing == this->transitions[cell] )
+      {
+        this->transitions[cell] = static_cast< std::uint32_t >( stateOutputs.size() );
+        this->transitions.resize( this->transitions.size() + alphabet, missing );
+        stateOutputs.emplace_back();
+      }
+      state = this->transitions[cell];
+    }
+    stateOutputs[state].push_back( index );
+  }
+
+  // breadth first completion of the missing transitions with the failure links
+  std::vector< std::uint32_t > failure( stateOutputs.size(), 0 );
+  std::queue< std::uint32_t > pending;
+  for ( std::size_t column = 0; column < alphabet; ++column )
+  {
+    std::uint32_t &target = this->transitions[column];
+    if ( missing == target )
+      target = 0;
+    else
+      pending.push( target );
+  }
+  while ( !pending.empty() )
+  {
+    const std::uint32_t state = pending.front();
+    pending.pop();
+
+    const std::vector< std::uint32_t > &inherited = stateOutputs[failure[state]];
+    stateOutputs[state].insert( stateOutputs[state].end(), inherited.begin(), inherited.end() );
+
+    for ( std::size_t column = 0; column < alphabet; ++column )
+    {
+      std::uint32_t &target = this->transitions[state * alphabet + column];
+      const std::uint32_t fallback = this->transitions[failure[state] * alphabet + column];
+      if ( missing == target )
+        target = fallback;
+      else
+      {
+        failure[target] = fallback;
+        pending.push( target );
+      }
+    }
+  }
+
+  this->outputOffsets.reserve( stateOutputs.size() + 1 );
+  this->outputOffsets.push_back( 0 );
+  for ( auto &&stateOutput: stateOutputs )
+  {
+    this->outputs.insert( this->outputs.end(), stateOutput.begin(), stateOutput.end() );
+    this->outputOffsets.push_back( static_cast< std::uint32_t >( this->outputs.size() ) );
+  }
+
+  for ( auto &&target: this->transitions )
+    if ( !stateOutputs[target].empty() )
+      target |= AcceptingFlag;
+}
+
+bool Qustodio::KeywordMatcher::extractKeywords ( const std::string &regexString, std::vector< std::string > &keywords )
+{
+  StringRef body( regexString );
+  const StringRef anything( ".*", 2 );
+
+  if ( body.size() >= 2 && StringRef( body.data(), 2 ) == anything )
+    body = StringRef( body.data() + 2, body.size() - 2 );
+  if ( body.size() >= 2 && StringRef( body.data() + body.size() - 2, 2 ) == anything )
+    body = StringRef( body.data(), body.size() - 2 );
+
+  // the filters count the events whose first group is not empty, so the alternation must be that group
+  if ( body.size() < 3 || '(' != body[0] || ')' != body[body.size() - 1] || '?' == body[1] )
+    return false;
+
+  std::vector< std::string > literals( 1 );
+  for ( std::size_t i = 1; i + 1 < body.size(); ++i )
+  {
+    const char character = body[i];
+    if ( '\\' == character )
+    {
+      // only escaped punctuation is a literal, \d, \w and friends are classes
+      if ( i + 2 >= body.size() || std::isalnum( static_cast< unsigned char >( body[i + 1] ) ) )
+        return false;
+      literals.back().push_back( body[++i] );
+    }
+    else if ( '|' == character )
+      literals.emplace_back();
+    else if ( nullptr != std::strchr( "^$.?*+()[]{}", character ) )
+      return false;
+    else
+      literals.back().push_back( character );
+  }
+
+  for ( auto &&literal: literals )
+    if ( literal.empty() )
+      return false;
+
+  keywords.swap( literals );
+  return true;
+}
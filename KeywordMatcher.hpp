@@ -0,0 +1,137 @@
+/** @file
+ * @brief Keyword Matcher
+ *
+ * This file contains the Aho-Corasick automaton used by the filters to look for many plain keywords at once
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref KeywordMatcher_legal_note_sec
+ *
+ * @section KeywordMatcher_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section KeywordMatcher_intro_sec Introduction
+ *
+ * The keywords are compiled once into a deterministic automaton stored as a flat transition table: one row per
+ * state and one column per byte class (the bytes that appear in some keyword, everything else shares a class). Every
+ * url is then scanned once, one table lookup per byte, whatever the number of keywords. The accepting states are
+ * flagged in the high bit of the transitions so the scan loop only has one branch per byte.
+ *
+ * @section KeywordMatcher_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section KeywordMatcher_install_sec Use
+ *
+ * @subsection KeywordMatcher_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef KEYWORDMATCHER_HPP
+#define KEYWORDMATCHER_HPP
+
+#include "StringRef.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class KeywordMatcher KeywordMatcher.hpp "KeywordMatcher.hpp"
+ *  \brief Multi-pattern substring matcher (Aho-Corasick).
+ *
+ * Immutable once built, so a single instance can be shared by every worker of a #ComposerPool.
+ */
+  class KeywordMatcher
+  {
+    public:
+    /**
+     * @brief Builds a matcher without keywords, that never matches
+     */
+    KeywordMatcher ();
+
+    /**
+     * @brief Compiles the keywords into the automaton
+     * @param keywords [in] the keywords to look for, empty keywords are ignored
+     * @param caseInsensitive [in] true to match ASCII letters regardless of their case
+     */
+    explicit KeywordMatcher ( const std::vector< std::string > &keywords, bool caseInsensitive = false );
+
+    /**
+     * @brief Checks whether any keyword occurs in #text
+     */
+    bool matches ( StringRef text ) const;
+
+    /**
+     * @brief Calls #onMatch for every occurrence of every keyword in #text
+     * @param text [in] the text to scan
+     * @param onMatch [in] callable receiving the keyword index and the position past the end of the occurrence
+     */
+    template < class Callback >
+    void forEachMatch ( StringRef text, Callback &&onMatch ) const;
+
+    std::size_t keywordCount () const { return keywords.size(); }                     //< Number of compiled keywords
+    const std::string &keyword ( std::size_t index ) const { return keywords[index]; } //< The keyword #index
+    std::size_t stateCount () const { return transitions.size() / alphabetSize; }     //< States of the automaton
+
+    /**
+     * @brief Recognises regular expressions that are just an alternation of literals, such as `.*(porn|xxx).*`
+     * @param regexString [in] the regular expression
+     * @param keywords [out] the literals of the alternation
+     * @return true when #regexString is equivalent to looking for #keywords anywhere in the text
+     */
+    static bool extractKeywords ( const std::string &regexString, std::vector< std::string > &keywords );
+
+    private:
+    static const std::uint32_t AcceptingFlag = 0x80000000u; //< Set in a transition that reaches an accepting state
+    static const std::uint32_t StateMask = 0x7fffffffu;     //< The target state of a transition
+
+    std::uint32_t next ( std::uint32_t state, unsigned char byte ) const
+    {
+      return transitions[( state & StateMask ) * alphabetSize + byteClass[byte]];
+    }
+
+    std::array< std::uint16_t, 256 > byteClass;   //< Byte to column of #transitions
+    std::size_t alphabetSize = 1;                  //< Columns of #transitions
+    std::vector< std::uint32_t > transitions;      //< Flat state x class table
+    std::vector< std::uint32_t > outputOffsets;    //< Outputs of state s are [outputOffsets[s], outputOffsets[s + 1])
+    std::vector< std::uint32_t > outputs;          //< Keyword indexes ending at each state
+    std::vector< std::string > keywords;           //< The compiled keywords
+  };
+
+  inline bool KeywordMatcher::matches ( StringRef text ) const
+  {
+    std::uint32_t state = 0;
+    for ( char character: text )
+    {
+      state = this->next( state, static_cast< unsigned char >( character ) );
+      if ( state & AcceptingFlag )
+        return true;
+    }
+    return false;
+  }
+
+  template < class Callback >
+  void KeywordMatcher::forEachMatch ( StringRef text, Callback &&onMatch ) const
+  {
+    std::uint32_t state = 0;
+    for ( std::size_t position = 0; position < text.size(); ++position )
+    {
+      state = this->next( state, static_cast< unsigned char >( text[position] ) );
+      if ( state & AcceptingFlag )
+      {
+        const std::uint32_t current = state & StateMask;
+        for ( std::uint32_t i = outputOffsets[current]; i != outputOffsets[current + 1]; ++i )
+          onMatch( static_cast< std::size_t >( outputs[i] ), position + 1 );
+      }
+    }
+  }
+
+} // namespace Qustodio
+
+#endif // KEYWORDMATCHER_HPP
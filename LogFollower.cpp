@@ -0,0 +1,217 @@
+#include "LogFollower.hpp"
+
+#include <chrono>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  const std::size_t readBufferSize = 64 * 1024; //< Bytes read per system call
+  const std::size_t readLimit = 1024 * 1024;    //< Bytes handed out per #LogFollower::poll, keeps the memory bounded
+} // namespace
+
+Qustodio::LogFollower::~LogFollower ()
+{
+  this->close();
+}
+
+bool Qustodio::LogFollower::open ( const std::string &fileToFollow, bool fromStart )
+{
+  this->close();
+
+  const std::string::size_type slash = fileToFollow.rfind( '/' );
+  const std::string folder = std::string::npos == slash ? std::string( "." )
+                                                        : 0 == slash ? std::string( "/" )
+                                                                     : fileToFollow.substr( 0, slash );
+  this->m_Name = std::string::npos == slash ? fileToFollow : fileToFollow.substr( slash + 1 );
+  this->m_Path = fileToFollow;
+
+  this->m_Notify = ::inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+  if ( this->m_Notify < 0 )
+    return false;
+
+  // the folder, not the file, so a rotated log is noticed when it is created again
+  this->m_Watch = ::inotify_add_watch( this->m_Notify, folder.c_str(),
+                                       IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                                       | IN_MOVED_TO | IN_ATTRIB );
+  if ( this->m_Watch < 0 )
+  {
+    this->close();
+    return false;
+  }
+
+  this->m_FromStart = fromStart;
+  std::vector< char > discarded;
+  this->reopen( discarded );
+  // a log created after this point is always read from its start
+  this->m_FromStart = true;
+  return true;
+}
+
+void Qustodio::LogFollower::close ()
+{
+  if ( this->m_File >= 0 )
+    ::close( this->m_File );
+  if ( this->m_Notify >= 0 )
+    ::close( this->m_Notify );
+
+  this->m_File = -1;
+  this->m_Notify = -1;
+  this->m_Watch = -1;
+  this->m_Device = 0;
+  this->m_Inode = 0;
+  this->m_Offset = 0;
+  this->m_Partial.clear();
+}
+
+std::size_t Qustodio::LogFollower::poll ( int timeoutMilliseconds, std::vector< char > &lines )
+{
+  if ( !this->is_open() )
+    return 0;
+
+  std::size_t appended = this->drain( lines );
+  if ( appended < readLimit )
+  {
+    appended += this->reopen( lines );
+    appended += this->drain( lines );
+  }
+  if ( appended > 0 || 0 == timeoutMilliseconds )
+    return appended;
+
+  // the writes to the other files of the folder don't count, a rotated log is drained on the next timeout
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( timeoutMilliseconds );
+  struct pollfd notification = { this->m_Notify, POLLIN, 0 };
+  int remaining = timeoutMilliseconds;
+  while ( ::poll( & notification, 1, remaining ) > 0 && !this->notified() )
+  {
+    if ( timeoutMilliseconds < 0 )
+      continue;
+    remaining = static_cast< int >( std::chrono::duration_cast< std::chrono::milliseconds >(
+            deadline - std::chrono::steady_clock::now() ).count() );
+    if ( remaining <= 0 )
+      break;
+  }
+
+  appended = this->drain( lines );
+  appended += this->reopen( lines );
+  return appended + this->drain( lines );
+}
+
+bool Qustodio::LogFollower::notified ()
+{
+  // the events only wake us up, the file itself tells what changed
+  bool relevant = false;
+  alignas( struct inotify_event ) char events[4096];
+  ssize_t bytes = 0;
+  while ( ( bytes = ::read( this->m_Notify, events, sizeof( events ) ) ) > 0 )
+  {
+    for ( ssize_t offset = 0; offset < bytes; )
+    {
+      const struct inotify_event *event = reinterpret_cast< const struct inotify_event * >( events + offset );
+      if ( ( event->mask & ( IN_Q_OVERFLOW | IN_IGNORED ) ) || ( event->len > 0 && this->m_Name == event->name ) )
+        relevant = true;
+      offset += static_cast< ssize_t >( sizeof( struct inotify_event ) + event->len );
+    }
+  }
+  return relevant;
+}
+
+std::size_t Qustodio::LogFollower::reopen ( std::vector< char > &lines )
+{
+  std::size_t appended = 0;
+  struct stat status;
+  if ( ::stat( this->m_Path.c_str(), & status ) != 0 )
+    // rotated away and not created yet, the writer may still append to the old file
+    return appended;
+
+  const std::uint64_t device = static_cast< std::uint64_t >( status.st_dev );
+  const std::uint64_t inode = static_cast< std::uint64_t >( status.st_ino );
+
+  if ( this->m_File >= 0 && device == this->m_Device && inode == this->m_Inode )
+  {
+    // truncated in place, start over
+    if ( static_cast< std::uint64_t >( status.st_size ) < this->m_Offset )
+    {
+      ::lseek( this->m_File, 0, SEEK_SET );
+      this->m_Offset = 0;
+      this->m_Partial.clear();
+    }
+    return appended;
+  }
+
+  if ( this->m_File >= 0 )
+  {
+    // the old file is complete, its last line will never get its line break
+    appended += this->drain( lines );
+    if ( !this->m_Partial.empty() )
+    {
+      lines.insert( lines.end(), this->m_Partial.begin(), this->m_Partial.end() );
+      lines.push_back( '\n' );
+      appended += this->m_Partial.size() + 1;
+      this->m_Partial.clear();
+    }
+    ::close( this->m_File );
+    this->m_File = -1;
+  }
+
+  const int descriptor = ::open( this->m_Path.c_str(), O_RDONLY | O_CLOEXEC );
+  if ( descriptor < 0 )
+    return appended;
+
+  struct stat opened;
+  if ( ::fstat( descriptor, & opened ) != 0 )
+  {
+    ::close( descriptor );
+    return appended;
+  }
+
+  this->m_File = descriptor;
+  this->m_Device = static_cast< std::uint64_t >( opened.st_dev );
+  this->m_Inode = static_cast< std::uint64_t >( opened.st_ino );
+  this->m_Offset = 0;
+  if ( !this->m_FromStart )
+  {
+    // only the bytes appended from now on, the end of a line being written reads as a line of its own
+    this->m_Offset = static_cast< std::uint64_t >( opened.st_size );
+    ::lseek( this->m_File, static_cast< off_t >( this->m_Offset ), SEEK_SET );
+  }
+  return appended;
+}
+
+std::size_t Qustodio::LogFollower::drain ( std::vector< char > &lines )
+{
+  if ( this->m_File < 0 )
+    return 0;
+
+  std::size_t appended = 0;
+  char buffer[readBufferSize];
+  while ( appended < readLimit )
+  {
+    const ssize_t bytes = ::read( this->m_File, buffer, sizeof( buffer ) );
+    if ( bytes <= 0 )
+      break;
+    this->m_Offset += static_cast< std::uint64_t >( bytes );
+
+    const char *const first = buffer;
+    const char *const end = buffer + bytes;
+    const char *lineEnd = end;
+    while ( lineEnd != first && '\n' != * ( lineEnd - 1 ) )
+      --lineEnd;
+
+    if ( lineEnd == first )
+    {
+      this->m_Partial.insert( this->m_Partial.end(), first, end );
+      continue;
+    }
+
+    appended += this->m_Partial.size() + static_cast< std::size_t >( lineEnd - first );
+    lines.insert( lines.end(), this->m_Partial.begin(), this->m_Partial.end() );
+    lines.insert( lines.end(), first, lineEnd );
+    this->m_Partial.assign( lineEnd, end );
+  }
+  return appended;
+}
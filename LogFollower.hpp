@@ -0,0 +1,119 @@
+/** @file
+ * @brief Log Follower
+ *
+ * This file contains the tail of a browsing log that keeps growing while it is read
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref LogFollower_legal_note_sec
+ *
+ * @section LogFollower_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section LogFollower_intro_sec Introduction
+ *
+ * The follower keeps the log open and sleeps on inotify until the writer appends data, then reads only the new bytes.
+ * It hands out whole lines only: a trailing line without its line break waits for the rest of it.
+ *
+ * A log that is truncated is read again from the start. A log that is rotated, renamed or deleted and created again under
+ * the same name, is drained to its end, including its last unterminated line, before the new file is opened.
+ *
+ * @section LogFollower_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section LogFollower_install_sec Use
+ *
+ * @subsection LogFollower_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef LOGFOLLOWER_HPP
+#define LOGFOLLOWER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class LogFollower LogFollower.hpp "LogFollower.hpp"
+ *  \brief Reads the lines appended to a log, surviving truncation and rotation.
+ */
+  class LogFollower
+  {
+    public:
+    LogFollower () = default;
+
+    ~LogFollower ();
+
+    LogFollower ( const LogFollower & ) = delete;
+
+    LogFollower &operator= ( const LogFollower & ) = delete;
+
+    /**
+     * @brief Starts following a log, releasing any previous one
+     *
+     * The log does not need to exist yet, it is opened as soon as it is created.
+     * @param fileToFollow [in] the log to follow
+     * @param fromStart [in] true to read the lines already in the log, false to read only the ones appended later
+     * @return false when the folder of the log can't be watched
+     */
+    bool open ( const std::string &fileToFollow, bool fromStart = true );
+
+    /**
+     * @brief Stops following the log
+     */
+    void close ();
+
+    /**
+     * @brief Waits for new data and appends the complete new lines to #lines
+     *
+     * Only the changes to a file named as the log wake it up before the timeout, not the other files of its folder.
+     * @param timeoutMilliseconds [in] longest wait when there is nothing new, 0 to return at once
+     * @param lines [in,out] receives whole lines, each one ended by a line break
+     * @return the number of bytes appended to #lines
+     */
+    std::size_t poll ( int timeoutMilliseconds, std::vector< char > &lines );
+
+    bool is_open () const { return m_Notify >= 0; } //< True when #open succeeded
+
+    private:
+    /**
+     * @brief Opens the log if there is none, or the new file once the current one has been replaced
+     * @param lines [in,out] receives the rest of a replaced file, its last unterminated line included
+     * @return the number of bytes appended to #lines
+     */
+    std::size_t reopen ( std::vector< char > &lines );
+
+    /**
+     * @brief Reads the bytes appended since the last call
+     * @param lines [in,out] receives the complete lines
+     * @return the number of bytes appended to #lines
+     */
+    std::size_t drain ( std::vector< char > &lines );
+
+    /**
+     * @brief Reads the pending inotify events
+     * @return true when one of them is about a file named #m_Name, or may have been lost
+     */
+    bool notified ();
+
+    std::string m_Path;           //< The followed log
+    std::string m_Name;           //< The name of the log inside its folder
+    int m_Notify = -1;            //< The inotify instance
+    int m_Watch = -1;             //< The watch of the folder of the log
+    int m_File = -1;              //< The log being read, -1 while it does not exist
+    std::uint64_t m_Device = 0;   //< Device of #m_File, tells rotations apart
+    std::uint64_t m_Inode = 0;    //< Inode of #m_File, tells rotations apart
+    std::uint64_t m_Offset = 0;   //< Bytes of #m_File already read
+    bool m_FromStart = true;      //< Whether the first file is read from its start
+    std::vector< char > m_Partial; //< The last line read, still without its line break
+  };
+
+} // namespace Qustodio
+
+#endif // LOGFOLLOWER_HPP
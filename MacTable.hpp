@@ -0,0 +1,139 @@
+/** @file
+ * @brief MAC Table
+ *
+ * This file contains the open addressing hash table from packed MAC-Addresses to device ids
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref MacTable_legal_note_sec
+ *
+ * @section MacTable_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section MacTable_intro_sec Introduction
+ *
+ * The Event Store looks every device up by its MAC-Address while ingesting, so the table is tuned for 48 bit integer
+ * keys: one flat array of key and id pairs, a multiplicative hash and linear probing, with the table kept at most half
+ * full. There are no per entry allocations and a lookup usually touches a single cache line.
+ *
+ * @section MacTable_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section MacTable_install_sec Use
+ *
+ * @subsection MacTable_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef MACTABLE_HPP
+#define MACTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class MacTable MacTable.hpp "MacTable.hpp"
+ *  \brief Open addressing map from a packed MAC-Address to a device id.
+ *
+ * The key `~0`, which no 48 bit MAC-Address can take, marks the empty slots.
+ */
+  class MacTable
+  {
+    public:
+    /**
+     * @brief Looks #mac up
+     * @param mac [in] the packed MAC-Address
+     * @param id [out] the device id stored for #mac
+     * @return false when #mac is not in the table
+     */
+    bool find ( std::uint64_t mac, std::uint32_t &id ) const
+    {
+      if ( this->slots.empty() )
+        return false;
+
+      for ( std::size_t slot = this->home( mac );; slot = ( slot + 1 ) & ( this->slots.size() - 1 ) )
+      {
+        if ( this->slots[slot].mac == mac )
+        {
+          id = this->slots[slot].id;
+          return true;
+        }
+        if ( EmptyKey == this->slots[slot].mac )
+          return false;
+      }
+    }
+
+    /**
+     * @brief Stores #id for #mac, keeping the id already stored if there is one
+     */
+    void insert ( std::uint64_t mac, std::uint32_t id )
+    {
+      if ( 2 * ( this->count + 1 ) > this->slots.size() )
+        this->grow();
+
+      std::size_t slot = this->home( mac );
+      while ( EmptyKey != this->slots[slot].mac )
+      {
+        if ( this->slots[slot].mac == mac )
+          return;
+        slot = ( slot + 1 ) & ( this->slots.size() - 1 );
+      }
+      this->slots[slot].mac = mac;
+      this->slots[slot].id = id;
+      ++this->count;
+    }
+
+    void clear ()
+    {
+      this->slots.clear();
+      this->count = 0;
+    }
+
+    std::size_t size () const { return this->count; }                                 //< Number of stored MACs
+    std::size_t memoryUsage () const { return this->slots.capacity() * sizeof( Slot ); } //< Bytes of the slots
+
+    private:
+    static const std::uint64_t EmptyKey = ~std::uint64_t( 0 ); //< Key of the empty slots
+
+    struct Slot
+    {
+      std::uint64_t mac;
+      std::uint32_t id;
+    };
+
+    std::size_t home ( std::uint64_t mac ) const
+    {
+      // Fibonacci hashing, the high bits are the best mixed ones
+      return static_cast< std::size_t >( ( mac * 0x9E3779B97F4A7C15ull ) >> this->shift );
+    }
+
+    void grow ()
+    {
+      std::vector< Slot > previous;
+      previous.swap( this->slots );
+
+      const std::size_t capacity = previous.empty() ? 16 : 2 * previous.size();
+      this->slots.assign( capacity, Slot { EmptyKey, 0 } );
+      this->shift = 64;
+      for ( std::size_t bits = capacity; bits > 1; bits >>= 1 )
+        --this->shift;
+
+      this->count = 0;
+      for ( auto &&slot: previous )
+        if ( EmptyKey != slot.mac )
+          this->insert( slot.mac, slot.id );
+    }
+
+    std::vector< Slot > slots; //< Power of two array of pairs, at most half full
+    std::size_t count = 0;     //< Number of stored MACs
+    unsigned shift = 64;       //< 64 minus the bits of the number of slots
+  };
+
+} // namespace Qustodio
+
+#endif // MACTABLE_HPP
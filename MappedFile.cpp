@@ -0,0 +1,58 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Qustodio::MappedFile::~MappedFile ()
+{
+  this->close();
+}
+
+bool Qustodio::MappedFile::open ( const std::string &fileToMap )
+{
+  this->close();
+
+  const int descriptor = ::open( fileToMap.c_str(), O_RDONLY );
+  if ( descriptor < 0 )
+    return false;
+
+  struct stat status;
+  // pipes and devices report no size, their readers fall back to reading them line by line
+  if ( ::fstat( descriptor, & status ) != 0 || !S_ISREG( status.st_mode ) )
+  {
+    ::close( descriptor );
+    return false;
+  }
+
+  const std::size_t size = static_cast< std::size_t >( status.st_size );
+  if ( size > 0 )
+  {
+    void *mapping = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+    if ( MAP_FAILED == mapping )
+    {
+      ::close( descriptor );
+      return false;
+    }
+    // the parsers read the mapping front to back once
+    ::madvise( mapping, size, MADV_SEQUENTIAL );
+    this->m_Data = static_cast< const char * >( mapping );
+  }
+
+  // the mapping stays valid after closing the descriptor
+  ::close( descriptor );
+  this->m_Size = size;
+  this->m_Open = true;
+  return true;
+}
+
+void Qustodio::MappedFile::close ()
+{
+  if ( nullptr != this->m_Data )
+    ::munmap( const_cast< char * >( this->m_Data ), this->m_Size );
+
+  this->m_Data = nullptr;
+  this->m_Size = 0;
+  this->m_Open = false;
+}
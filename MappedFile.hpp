@@ -0,0 +1,76 @@
+/** @file
+ * @brief Mapped File
+ *
+ * This file contains the read only memory mapping of a file used by the zero-copy ingestion
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref MappedFile_legal_note_sec
+ *
+ * @section MappedFile_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section MappedFile_intro_sec Introduction
+ *
+ * Maps a whole file in memory with POSIX mmap so the parsers can reference its bytes without copying them. The
+ * mapping is released when the object is destroyed, so anything viewing the bytes must keep the MappedFile alive.
+ *
+ * @section MappedFile_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section MappedFile_install_sec Use
+ *
+ * @subsection MappedFile_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace Qustodio
+{
+
+/*! \class MappedFile MappedFile.hpp "MappedFile.hpp"
+ *  \brief RAII owner of a read only file mapping.
+ */
+  class MappedFile
+  {
+    public:
+    MappedFile () = default;
+
+    ~MappedFile ();
+
+    MappedFile ( const MappedFile & ) = delete;
+
+    MappedFile &operator= ( const MappedFile & ) = delete;
+
+    /**
+     * @brief Maps the whole file, releasing any previous mapping
+     * @param fileToMap [in] the file to map
+     * @return false when the file can't be opened or mapped
+     */
+    bool open ( const std::string &fileToMap );
+
+    /**
+     * @brief Releases the mapping
+     */
+    void close ();
+
+    const char *data () const { return m_Data; } //< First byte of the mapping, nullptr for empty files
+    std::size_t size () const { return m_Size; } //< Number of mapped bytes
+    bool is_open () const { return m_Open; }     //< True when #open succeeded
+
+    private:
+    const char *m_Data = nullptr; //< First byte of the mapping
+    std::size_t m_Size = 0;       //< Number of mapped bytes
+    bool m_Open = false;          //< True when #open succeeded
+  };
+
+} // namespace Qustodio
+
+#endif // MAPPEDFILE_HPP
@@ -0,0 +1,589 @@
+#include "RegexDfa.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+const std::size_t Qustodio::RegexDfa::MaxStates;
+const std::size_t Qustodio::RegexDfa::MaxRepeat;
+const std::uint32_t Qustodio::RegexDfa::DeadState;
+
+namespace
+{
+  typedef std::bitset< 256 > ByteSet;
+
+  const std::size_t maxNfaStates = 16384; //< Bound of the expansion of `{n,m}`
+
+  struct NfaState
+  {
+    enum Kind
+    {
+      Bytes,     //< Consumes a byte of #bytes and goes to #out
+      Epsilon,   //< Goes to #out
+      Split,     //< Goes to #out and #out1
+      Match,     //< The pattern matched
+      MatchAtEnd //< The pattern matched if the text ends here
+    };
+
+    Kind kind;
+    ByteSet bytes;
+    int out = -1;
+    int out1 = -1;
+  };
+
+  /**
+   * @brief Recursive descent parser building a Thompson NFA
+   */
+  class NfaBuilder
+  {
+    public:
+    struct Fragment
+    {
+      int start;
+      std::vector< std::pair< int, int > > outs; //< Dangling (state, slot) arrows
+    };
+
+    NfaBuilder ( const std::string &pattern, std::size_t first, std::size_t last )
+            : pattern( pattern ), position( first ), last( last )
+    { }
+
+    Fragment parseAlternation ( bool topLevel )
+    {
+      Fragment fragment = this->parseConcatenation();
+      while ( this->position < this->last && '|' == this->pattern[this->position] )
+      {
+        ++this->position;
+        if ( topLevel )
+          this->topLevelAlternation = true;
+        fragment = this->alternate( fragment, this->parseConcatenation() );
+      }
+      return fragment;
+    }
+
+    int add ( NfaState::Kind kind )
+    {
+      if ( this->states.size() >= maxNfaStates )
+        throw std::invalid_argument( "Regular expression too large" );
+      NfaState state;
+      state.kind = kind;
+      this->states.push_back( state );
+      return static_cast< int >( this->states.size() - 1 );
+    }
+
+    void patch ( const Fragment &fragment, int target )
+    {
+      for ( auto &&out: fragment.outs )
+        ( 0 == out.second ? this->states[out.first].out : this->states[out.first].out1 ) = target;
+    }
+
+    bool atEnd () const { return this->position >= this->last; }
+
+    std::vector< NfaState > states;
+    bool topLevelAlternation = false;
+
+    private:
+    Fragment bytes ( const ByteSet &set )
+    {
+      const int state = this->add( NfaState::Bytes );
+      this->states[state].bytes = set;
+      return Fragment{ state, { { state, 0 } } };
+    }
+
+    Fragment empty ()
+    {
+      const int state = this->add( NfaState::Epsilon );
+      return Fragment{ state, { { state, 0 } } };
+    }
+
+    Fragment concatenate ( const Fragment &first, const Fragment &second )
+    {
+      this->patch( first, second.start );
+      return Fragment{ first.start, second.outs };
+    }
+
+    Fragment alternate ( const Fragment &first, const Fragment &second )
+    {
+      const int state = this->add( NfaState::Split );
+      this->states[state].out = first.start;
+      this->states[state].out1 = second.start;
+      Fragment fragment{ state, first.outs };
+      fragment.outs.insert( fragment.outs.end(), second.outs.begin(), second.outs.end() );
+      return fragment;
+    }
+
+    Fragment star ( const Fragment &inner )
+    {
+      const int state = this->add( NfaState::Split );
+      this->states[state].out = inner.start;
+      this->patch( inner, state );
+      return Fragment{ state, { { state, 1 } } };
+    }
+
+    Fragment optional ( const Fragment &inner )
+    {
+      const int state = this->add( NfaState::Split );
+      this->states[state].out = inner.start;
+      Fragment fragment{ state, inner.outs };
+      fragment.outs.push_back( { state, 1 } );
+      return fragment;
+    }
+
+    Fragment parseConcatenation ()
+    {
+      Fragment fragment = this->empty();
+      while ( this->position < this->last && '|' != this->pattern[this->position]
+              && ')' != this->pattern[this->position] )
+        fragment = this->concatenate( fragment, this->parseRepetition() );
+      return fragment;
+    }
+
+    /**
+     * @brief Parses an atom and its quantifier, parsing the atom again for every mandatory copy of `{n,m}`
+     */
+    Fragment parseRepetition ()
+    {
+      const std::size_t atomStart = this->position;
+      Fragment fragment = this->parseAtom();
+      if ( this->atEnd() )
+        return fragment;
+
+      std::size_t minimum = 1;
+      std::size_t maximum = 1;
+      bool unbounded = false;
+      switch ( this->pattern[this->position] )
+      {
+        case '*':
+          minimum = 0;
+          unbounded = true;
+          ++this->position;
+          break;
+        case '+':
+          unbounded = true;
+          ++this->position;
+          break;
+        case '?':
+          minimum = 0;
+          ++this->position;
+          break;
+        case '{':
+          if ( !this->parseBounds( minimum, maximum, unbounded ) )
+            return fragment;
+          break;
+        default:
+          return fragment;
+      }
+      // lazy quantifiers find the same matches
+      if ( !this->atEnd() && '?' == this->pattern[this->position] )
+        ++this->position;
+      if ( !this->atEnd() && ( '*' == this->pattern[this->position] || '+' == this->pattern[this->position]
+                               || '?' == this->pattern[this->position] ) )
+        throw std::invalid_argument( "Nothing to repeat in regular expression" );
+
+      auto copyAtom = [ this, atomStart ] ()
+      {
+        const std::size_t resume = this->position;
+        this->position = atomStart;
+        Fragment copy = this->parseAtom();
+        this->position = resume;
+        return copy;
+      };
+
+      Fragment result = this->empty();
+      for ( std::size_t copy = 0; copy < minimum; ++copy )
+        result = this->concatenate( result, 0 == copy ? fragment : copyAtom() );
+
+      if ( unbounded )
+        result = this->concatenate( result, this->star( 0 == minimum ? fragment : copyAtom() ) );
+      else
+      {
+        // a? (a (a)?)? nesting keeps the NFA linear in the bound
+        Fragment tail = this->empty();
+        bool hasTail = false;
+        for ( std::size_t copy = minimum; copy < maximum; ++copy )
+        {
+          Fragment atom = ( 0 == copy && 0 == minimum && !hasTail ) ? fragment : copyAtom();
+          tail = hasTail ? this->optional( this->concatenate( atom, tail ) ) : this->optional( atom );
+          hasTail = true;
+        }
+        if ( hasTail )
+          result = this->concatenate( result, tail );
+      }
+      return result;
+    }
+
+    /**
+     * @brief Parses `{n}`, `{n,}` or `{n,m}`; a `{` not followed by bounds is a literal
+     */
+    bool parseBounds ( std::size_t &minimum, std::size_t &maximum, bool &unbounded )
+    {
+      std::size_t cursor = this->position + 1;
+      auto number = [ this, &cursor ] ( std::size_t &value )
+      {
+        const std::size_t begin = cursor;
+        value = 0;
+        while ( cursor < this->last && std::isdigit( static_cast< unsigned char >( this->pattern[cursor] ) ) )
+        {
+          value = value * 10 + static_cast< std::size_t >( this->pattern[cursor] - '0' );
+          if ( value > Qustodio::RegexDfa::MaxRepeat )
+            throw std::invalid_argument( "Repetition bound too large in regular expression" );
+          ++cursor;
+        }
+        return cursor != begin;
+      };
+
+      if ( !number( minimum ) )
+        return false;
+      maximum = minimum;
+      unbounded = false;
+      if ( cursor < this->last && ',' == this->pattern[cursor] )
+      {
+        ++cursor;
+        if ( !number( maximum ) )
+          unbounded = true;
+      }
+      if ( cursor >= this->last || '}' != this->pattern[cursor] )
+        return false;
+      if ( !unbounded && maximum < minimum )
+        throw std::invalid_argument( "Invalid repetition bounds in regular expression" );
+
+      this->position = cursor + 1;
+      return true;
+    }
+
+    Fragment parseAtom ()
+    {
+      const char character = this->pattern[this->position++];
+      switch ( character )
+      {
+        case '(':
+        {
+          if ( !this->atEnd() && '?' == this->pattern[this->position] )
+          {
+            if ( this->position + 1 < this->last && ':' == this->pattern[this->position + 1] )
+              this->position += 2;
+            else
+              throw std::invalid_argument( "Unsupported group in regular expression" );
+          }
+          Fragment group = this->parseAlternation( false );
+          if ( this->atEnd() || ')' != this->pattern[this->position] )
+            throw std::invalid_argument( "Unbalanced parenthesis in regular expression" );
+          ++this->position;
+          return group;
+        }
+        case '.':
+        {
+          ByteSet set;
+          set.set();
+          set.reset( '\n' );
+          set.reset( '\r' );
+          return this->bytes( set );
+        }
+        case '[':
+          return this->bytes( this->parseClass() );
+        case '\\':
+          return this->bytes( this->parseEscape( false ) );
+        case '*':
+        case '+':
+        case '?':
+          throw std::invalid_argument( "Nothing to repeat in regular expression" );
+        case '^':
+        case '$':
+          throw std::invalid_argument( "Anchors are only supported at the ends of the regular expression" );
+        default:
+        {
+          ByteSet set;
+          set.set( static_cast< unsigned char >( character ) );
+          return this->bytes( set );
+        }
+      }
+    }
+
+    /**
+     * @brief Parses the escape after a backslash
+     * @param inClass [in] true inside brackets, where `\b` is a backspace
+     */
+    ByteSet parseEscape ( bool inClass )
+    {
+      if ( this->atEnd() )
+        throw std::invalid_argument( "Trailing backslash in regular expression" );
+
+      const char character = this->pattern[this->position++];
+      ByteSet set;
+      switch ( character )
+      {
+        case 'd':
+        case 'D':
+          for ( int byte = '0'; byte <= '9'; ++byte )
+            set.set( static_cast< std::size_t >( byte ) );
+          return 'D' == character ? ~set : set;
+        case 'w':
+        case 'W':
+          for ( int byte = 0; byte < 256; ++byte )
+            if ( std::isalnum( byte ) || '_' == byte )
+              set.set( static_cast< std::size_t >( byte ) );
+          return 'W' == character ? ~set : set;
+        case 's':
+        case 'S':
+          for ( char space: std::string( " \t\n\r\f\v" ) )
+            set.set( static_cast< unsigned char >( space ) );
+          return 'S' == character ? ~set : set;
+        case 't':
+          set.set( '\t' );
+          return set;
+        case 'n':
+          set.set( '\n' );
+          return set;
+        case 'r':
+          set.set( '\r' );
+          return set;
+        case 'f':
+          set.set( '\f' );
+          return set;
+        case 'v':
+          set.set( '\v' );
+          return set;
+        case 'b':
+          if ( inClass )
+          {
+            set.set( '\b' );
+            return set;
+          }
+          throw std::invalid_argument( "Word boundaries are not supported in regular expression" );
+        case 'x':
+        {
+          if ( this->position + 2 > this->last
+               || !std::isxdigit( static_cast< unsigned char >( this->pattern[this->position] ) )
+               || !std::isxdigit( static_cast< unsigned char >( this->pattern[this->position + 1] ) ) )
+            throw std::invalid_argument( "Invalid hexadecimal escape in regular expression" );
+          set.set( static_cast< std::size_t >( std::stoi( this->pattern.substr( this->position, 2 ), nullptr, 16 ) ) );
+          this->position += 2;
+          return set;
+        }
+        default:
+          if ( std::isalnum( static_cast< unsigned char >( character ) ) )
+            throw std::invalid_argument( "Unsupported escape in regular expression" );
+          set.set( static_cast< unsigned char >( character ) );
+          return set;
+      }
+    }
+
+    ByteSet parseClass ()
+    {
+      bool negated = false;
+      if ( !this->atEnd() && '^' == this->pattern[this->position] )
+      {
+        negated = true;
+        ++this->position;
+      }
+
+      ByteSet set;
+      while ( !this->atEnd() && ']' != this->pattern[this->position] )
+      {
+        bool classEscape = false;
+        ByteSet item = this->parseClassAtom( classEscape );
+        if ( this->position + 1 < this->last && '-' == this->pattern[this->position]
+             && ']' != this->pattern[this->position + 1] )
+        {
+          ++this->position;
+          bool classEscapeEnd = false;
+          const ByteSet end = this->parseClassAtom( classEscapeEnd );
+          // std::regex rejects [\d-x] and [a-\d]
+          if ( classEscape || classEscapeEnd )
+            throw std::invalid_argument( "Invalid range in regular expression" );
+
+          std::size_t low = 0;
+          std::size_t high = 0;
+          while ( !item.test( low ) )
+            ++low;
+          while ( !end.test( high ) )
+            ++high;
+          if ( high < low )
+            throw std::invalid_argument( "Invalid range in regular expression" );
+          for ( std::size_t byte = low; byte <= high; ++byte )
+            item.set( byte );
+        }
+        set |= item;
+      }
+      if ( this->atEnd() )
+        throw std::invalid_argument( "Unbalanced bracket in regular expression" );
+      ++this->position;
+
+      return negated ? ~set : set;
+    }
+
+    ByteSet parseClassAtom ( bool &classEscape )
+    {
+      const char character = this->pattern[this->position++];
+      ByteSet set;
+      if ( '\\' == character )
+      {
+        classEscape = !this->atEnd()
+                      && std::string::npos != std::string( "dDwWsS" ).find( this->pattern[this->position] );
+        return this->parseEscape( true );
+      }
+      // [[:alpha:]], [[=a=]] and [[.a.]] are not literal brackets for std::regex
+      if ( '[' == character && !this->atEnd()
+           && std::string::npos != std::string( ":=." ).find( this->pattern[this->position] ) )
+        throw std::invalid_argument( "Unsupported bracket expression in regular expression" );
+      set.set( static_cast< unsigned char >( character ) );
+      classEscape = false;
+      return set;
+    }
+
+    const std::string &pattern;
+    std::size_t position;
+    std::size_t last;
+  };
+
+  typedef std::vector< int > StateSet;
+
+  /**
+   * @brief Adds to #closure the consuming and matching states reachable from #state through epsilon arrows
+   */
+  void addClosure ( const std::vector< NfaState > &states, int state, std::vector< std::uint8_t > &visited,
+                    StateSet &closure )
+  {
+    std::vector< int > pending( 1, state );
+    while ( !pending.empty() )
+    {
+      const int current = pending.back();
+      pending.pop_back();
+      if ( current < 0 || visited[current] )
+        continue;
+      visited[current] = 1;
+
+      const NfaState &nfaState = states[current];
+      switch ( nfaState.kind )
+      {
+        case NfaState::Epsilon:
+          pending.push_back( nfaState.out );
+          break;
+        case NfaState::Split:
+          pending.push_back( nfaState.out1 );
+          pending.push_back( nfaState.out );
+          break;
+        default:
+          closure.push_back( current );
+          break;
+      }
+    }
+  }
+} // namespace
+
+Qustodio::RegexDfa::RegexDfa ( const std::string &regexString )
+{
+  std::size_t first = 0;
+  std::size_t last = regexString.size();
+  const bool anchoredStart = !regexString.empty() && '^' == regexString[0];
+  if ( anchoredStart )
+    ++first;
+
+  // a final $ is an anchor unless it is escaped by an odd number of backslashes
+  bool anchoredEnd = false;
+  if ( last > first && '$' == regexString[last - 1] )
+  {
+    std::size_t backslashes = 0;
+    while ( last - 1 - backslashes > first && '\\' == regexString[last - 2 - backslashes] )
+      ++backslashes;
+    anchoredEnd = 0 == backslashes % 2;
+    if ( anchoredEnd )
+      --last;
+  }
+
+  NfaBuilder builder( regexString, first, last );
+  NfaBuilder::Fragment fragment = builder.parseAlternation( true );
+  if ( !builder.atEnd() )
+    throw std::invalid_argument( "Unbalanced parenthesis in regular expression" );
+  if ( ( anchoredStart || anchoredEnd ) && builder.topLevelAlternation )
+    throw std::invalid_argument( "Anchors of a top level alternation are not supported in regular expression" );
+
+  const int match = builder.add( anchoredEnd ? NfaState::MatchAtEnd : NfaState::Match );
+  builder.patch( fragment, match );
+  const std::vector< NfaState > &states = builder.states;
+
+  // bytes that no consuming state tells apart share a column
+  std::vector< int > consuming;
+  for ( std::size_t state = 0; state < states.size(); ++state )
+    if ( NfaState::Bytes == states[state].kind )
+      consuming.push_back( static_cast< int >( state ) );
+
+  std::map< std::vector< bool >, std::uint16_t > signatures;
+  std::vector< unsigned char > representative;
+  for ( std::size_t byte = 0; byte < 256; ++byte )
+  {
+    std::vector< bool > signature( consuming.size() );
+    for ( std::size_t i = 0; i < consuming.size(); ++i )
+      signature[i] = states[consuming[i]].bytes.test( byte );
+    auto inserted = signatures.emplace( signature, static_cast< std::uint16_t >( signatures.size() ) );
+    if ( inserted.second )
+      representative.push_back( static_cast< unsigned char >( byte ) );
+    this->byteClass[byte] = inserted.first->second;
+  }
+  this->alphabetSize = representative.size();
+
+  // subset construction, searching anywhere means the start closure joins every state unless anchored
+  std::vector< std::uint8_t > visited( states.size(), 0 );
+  StateSet startSet;
+  addClosure( states, fragment.start, visited, startSet );
+  std::sort( startSet.begin(), startSet.end() );
+
+  std::map< StateSet, std::uint32_t > known;
+  std::vector< StateSet > sets;
+  auto intern = [ & ] ( StateSet &set ) -> std::uint32_t
+  {
+    std::sort( set.begin(), set.end() );
+    auto found = known.find( set );
+    if ( found != known.end() )
+      return found->second;
+    if ( sets.size() >= MaxStates )
+      throw std::invalid_argument( "Regular expression needs too many states" );
+
+    const std::uint32_t id = static_cast< std::uint32_t >( sets.size() );
+    bool accepts = false;
+    bool acceptsAtEnd = false;
+    for ( int state: set )
+    {
+      accepts = accepts || NfaState::Match == states[state].kind;
+      acceptsAtEnd = acceptsAtEnd || NfaState::Match == states[state].kind
+                     || NfaState::MatchAtEnd == states[state].kind;
+    }
+    known.emplace( set, id );
+    sets.push_back( set );
+    this->accepting.push_back( accepts ? 1 : 0 );
+    this->acceptingAtEnd.push_back( acceptsAtEnd ? 1 : 0 );
+    this->transitions.resize( this->transitions.size() + this->alphabetSize, DeadState );
+    return id;
+  };
+
+  StateSet dead;
+  intern( dead );
+  StateSet start = startSet;
+  this->startState = intern( start );
+
+  for ( std::uint32_t current = 0; current < sets.size(); ++current )
+  {
+    if ( DeadState == current )
+      continue;
+    for ( std::size_t column = 0; column < this->alphabetSize; ++column )
+    {
+      std::fill( visited.begin(), visited.end(), 0 );
+      StateSet next;
+      for ( int state: sets[current] )
+        if ( NfaState::Bytes == states[state].kind && states[state].bytes.test( representative[column] ) )
+          addClosure( states, states[state].out, visited, next );
+      if ( !anchoredStart )
+        for ( int state: startSet )
+          if ( !visited[state] )
+          {
+            visited[state] = 1;
+            next.push_back( state );
+          }
+
+      const std::uint32_t target = intern( next );
+      this->transitions[current * this->alphabetSize + column] = target;
+    }
+  }
+}
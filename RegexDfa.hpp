@@ -0,0 +1,105 @@
+/** @file
+ * @brief Regex DFA
+ *
+ * This file contains the deterministic automaton used by the filters to run regular expressions in linear time
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref RegexDfa_legal_note_sec
+ *
+ * @section RegexDfa_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section RegexDfa_intro_sec Introduction
+ *
+ * std::regex backtracks, so a pattern like `(a|aa)*b` written by an administrator can take exponential time on a
+ * single url and stall every worker. The supported subset of the ECMAScript syntax is compiled here into a Thompson NFA
+ * and then into a DFA by subset construction, which scans each url byte by byte exactly once.
+ *
+ * Supported syntax: literals, `.`, bracket classes with ranges and negation, the escapes `\\d \\w \\s` (and their
+ * negations) and escaped punctuation, groups `( )` and `(?: )`, alternation `|`, the quantifiers `* + ?` and `{n,m}`
+ * (lazy ones behave as greedy), `^` at the start and `$` at the end. Anything else, and patterns whose DFA would
+ * exceed #RegexDfa::MaxStates states, are rejected with std::invalid_argument.
+ *
+ * @section RegexDfa_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section RegexDfa_install_sec Use
+ *
+ * @subsection RegexDfa_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef REGEXDFA_HPP
+#define REGEXDFA_HPP
+
+#include "StringRef.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class RegexDfa RegexDfa.hpp "RegexDfa.hpp"
+ *  \brief Regular expression search compiled to a DFA over raw bytes.
+ *
+ * Only answers whether the pattern matches somewhere in the text, capture groups are not tracked.
+ * Immutable once built, so a single instance can be shared by every worker of a #ComposerPool.
+ */
+  class RegexDfa
+  {
+    public:
+    static const std::size_t MaxStates = 4096; //< Largest DFA accepted
+    static const std::size_t MaxRepeat = 64;   //< Largest bound accepted in `{n,m}`
+
+    /**
+     * @brief Compiles #regexString
+     * @param regexString [in] the regular expression
+     * @throw std::invalid_argument when the pattern is outside the supported subset or too large
+     */
+    explicit RegexDfa ( const std::string &regexString );
+
+    /**
+     * @brief Checks whether the pattern matches somewhere in #text
+     */
+    bool matches ( StringRef text ) const;
+
+    std::size_t stateCount () const { return accepting.size(); } //< States of the DFA
+
+    private:
+    static const std::uint32_t DeadState = 0; //< State from where nothing can match
+
+    std::array< std::uint16_t, 256 > byteClass; //< Byte to column of #transitions
+    std::size_t alphabetSize = 1;               //< Columns of #transitions
+    std::uint32_t startState = 0;               //< Initial state
+    std::vector< std::uint32_t > transitions;   //< Flat state x class table
+    std::vector< std::uint8_t > accepting;      //< The pattern has matched
+    std::vector< std::uint8_t > acceptingAtEnd; //< The pattern matches if the text ends here, for `$`
+  };
+
+  inline bool RegexDfa::matches ( StringRef text ) const
+  {
+    std::uint32_t state = this->startState;
+    if ( this->accepting[state] )
+      return true;
+
+    for ( char character: text )
+    {
+      state = this->transitions[state * this->alphabetSize + this->byteClass[static_cast< unsigned char >( character )]];
+      if ( this->accepting[state] )
+        return true;
+      if ( DeadState == state )
+        return false;
+    }
+    return 0 != this->acceptingAtEnd[state];
+  }
+
+} // namespace Qustodio
+
+#endif // REGEXDFA_HPP
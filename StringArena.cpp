@@ -0,0 +1,52 @@
+#include "StringArena.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+Qustodio::StringArena::StringArena ( std::size_t blockSize )
+        : blockSize( blockSize > 0 ? blockSize : DefaultBlockSize )
+{
+}
+
+Qustodio::StringRef Qustodio::StringArena::copy ( const char *data, std::size_t length )
+{
+  if ( 0 == length )
+    return StringRef( data, 0 );
+
+  // the free blocks too small for the copy are skipped, the next rewind gives them back
+  while ( this->current < this->blocks.size() && this->offset + length > this->blocks[this->current].size )
+  {
+    ++this->current;
+    this->offset = 0;
+  }
+
+  if ( this->current == this->blocks.size() )
+  {
+    Block block;
+    block.size = std::max( this->blockSize, length );
+    block.data.reset( new char[block.size] );
+    this->allocated += block.size;
+    this->blocks.push_back( std::move( block ) );
+    this->offset = 0;
+  }
+
+  char *target = this->blocks[this->current].data.get() + this->offset;
+  std::memcpy( target, data, length );
+  this->offset += length;
+  this->used += length;
+  return StringRef( target, length );
+}
+
+void Qustodio::StringArena::rewind ()
+{
+  this->current = 0;
+  this->offset = 0;
+  this->used = 0;
+}
+
+void Qustodio::StringArena::release ()
+{
+  std::vector< Block >().swap( this->blocks );
+  this->rewind();
+  this->allocated = 0;
+}
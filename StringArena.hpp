@@ -0,0 +1,95 @@
+/** @file
+ * @brief String Arena
+ *
+ * This file contains the monotonic arena holding the raw fields of the events while they are parsed
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref StringArena_legal_note_sec
+ *
+ * @section StringArena_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section StringArena_intro_sec Introduction
+ *
+ * The arena copies character ranges into a few large blocks by bumping a pointer, so a copy never calls the allocator
+ * once the blocks exist. Nothing is freed on its own: #StringArena::rewind makes every block reusable at once and
+ * #StringArena::release frees them all at once. An arena is owned by a single thread, so the readers running on the
+ * workers of a #ComposerPool never contend for the heap while they parse.
+ *
+ * @section StringArena_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section StringArena_install_sec Use
+ *
+ * @subsection StringArena_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef STRINGARENA_HPP
+#define STRINGARENA_HPP
+
+#include "StringRef.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class StringArena StringArena.hpp "StringArena.hpp"
+ *  \brief Monotonic arena of characters, released as a whole.
+ *
+ * The copies stay valid until the next #rewind or #release. Not synchronized.
+ */
+  class StringArena
+  {
+    public:
+    static const std::size_t DefaultBlockSize = 64 << 10; //< Bytes of every block, unless a copy needs more
+
+    explicit StringArena ( std::size_t blockSize = DefaultBlockSize );
+
+    StringArena ( const StringArena & ) = delete;
+
+    StringArena &operator= ( const StringArena & ) = delete;
+
+    /**
+     * @brief Copies #length characters at #data to the arena
+     * @return the copy, valid until the next #rewind or #release
+     */
+    StringRef copy ( const char *data, std::size_t length );
+
+    /**
+     * @brief Forgets every copy but keeps the blocks, so the next copies don't allocate
+     */
+    void rewind ();
+
+    /**
+     * @brief Forgets every copy and frees every block
+     */
+    void release ();
+
+    std::size_t size () const { return used; }          //< Bytes taken by the copies since the last #rewind
+    std::size_t capacity () const { return allocated; } //< Bytes of all the blocks
+
+    private:
+    struct Block
+    {
+      std::unique_ptr< char[] > data; //< The characters
+      std::size_t size;               //< Bytes of #data
+    };
+
+    std::size_t blockSize;       //< Bytes of a new block
+    std::vector< Block > blocks; //< Every block, the ones past #current are free
+    std::size_t current = 0;     //< The block copies go to
+    std::size_t offset = 0;      //< First free byte of the #current block
+    std::size_t used = 0;        //< See #size
+    std::size_t allocated = 0;   //< See #capacity
+  };
+
+} // namespace Qustodio
+
+#endif // STRINGARENA_HPP
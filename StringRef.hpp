@@ -0,0 +1,113 @@
+/** @file
+ * @brief String Reference
+ *
+ * This file contains a non owning reference to a range of characters
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref StringRef_legal_note_sec
+ *
+ * @section StringRef_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section StringRef_intro_sec Introduction
+ *
+ * C++11 has no std::string_view, so this is the minimal read only view used to hand out parts of a buffer
+ * (a memory mapped file, an arena) without copying them into a std::string.
+ *
+ * @section StringRef_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section StringRef_install_sec Use
+ *
+ * @subsection StringRef_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef STRINGREF_HPP
+#define STRINGREF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace Qustodio
+{
+
+/*! \class StringRef StringRef.hpp "StringRef.hpp"
+ *  \brief Non owning view of a character range.
+ *
+ * The referenced buffer must outlive the StringRef.
+ */
+  class StringRef
+  {
+    public:
+    typedef const char *const_iterator;
+
+    StringRef () = default;
+
+    StringRef ( const char *data, std::size_t length )
+            : m_Data( data ), m_Length( length )
+    { }
+
+    StringRef ( const std::string &string ) // implicit on purpose, as std::string_view
+            : m_Data( string.data() ), m_Length( string.size() )
+    { }
+
+    const char *data () const { return m_Data; }              //< First character of the range
+    std::size_t size () const { return m_Length; }            //< Number of characters of the range
+    std::size_t length () const { return m_Length; }          //< Number of characters of the range
+    bool empty () const { return 0 == m_Length; }             //< True when the range holds no characters
+    const_iterator begin () const { return m_Data; }          //< Iterator to the first character
+    const_iterator end () const { return m_Data + m_Length; } //< Iterator past the last character
+    char operator[] ( std::size_t position ) const { return m_Data[position]; }
+
+    /**
+     * @brief Copies the referenced characters into an owning string
+     */
+    std::string str () const { return std::string( m_Data, m_Length ); }
+
+    /**
+     * @brief Lexicographical comparison, same contract as std::string::compare
+     */
+    int compare ( const StringRef &other ) const
+    {
+      const std::size_t common = (std::min)( m_Length, other.m_Length );
+      const int result = common > 0 ? std::memcmp( m_Data, other.m_Data, common ) : 0;
+      if ( 0 != result )
+        return result;
+      return m_Length < other.m_Length ? -1 : ( m_Length > other.m_Length ? 1 : 0 );
+    }
+
+    private:
+    const char *m_Data = nullptr; //< First character of the range
+    std::size_t m_Length = 0;     //< Number of characters of the range
+  };
+
+  inline bool operator== ( const StringRef &lhs, const StringRef &rhs )
+  {
+    return lhs.size() == rhs.size() && ( lhs.empty() || 0 == std::memcmp( lhs.data(), rhs.data(), lhs.size() ) );
+  }
+
+  inline bool operator!= ( const StringRef &lhs, const StringRef &rhs )
+  {
+    return !( lhs == rhs );
+  }
+
+  inline bool operator< ( const StringRef &lhs, const StringRef &rhs )
+  {
+    return lhs.compare( rhs ) < 0;
+  }
+
+  inline std::ostream &operator<< ( std::ostream &stream, const StringRef &string )
+  {
+    return stream.write( string.data(), static_cast< std::streamsize >( string.size() ) );
+  }
+
+} // namespace Qustodio
+
+#endif // STRINGREF_HPP
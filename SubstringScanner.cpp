@@ -0,0 +1,210 @@
+#include "SubstringScanner.hpp"
+
+#include <cctype>
+#include <cstring>
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define SUBSTRINGSCANNER_X86 1
+#include <immintrin.h>
+#else
+#define SUBSTRINGSCANNER_X86 0
+#endif
+
+namespace
+{
+  inline char lower ( char character )
+  {
+    return ( character >= 'A' && character <= 'Z' ) ? static_cast< char >( character + ( 'a' - 'A' ) ) : character;
+  }
+
+  inline char upper ( char character )
+  {
+    return ( character >= 'a' && character <= 'z' ) ? static_cast< char >( character - ( 'a' - 'A' ) ) : character;
+  }
+
+  /**
+   * @brief Compares the inner bytes of a candidate whose first and last bytes already matched
+   */
+  inline bool verify ( const char *candidate, const char *keyword, std::size_t keywordLength, bool caseInsensitive )
+  {
+    if ( keywordLength <= 2 )
+      return true;
+    if ( !caseInsensitive )
+      return 0 == std::memcmp( candidate + 1, keyword + 1, keywordLength - 2 );
+    for ( std::size_t i = 1; i + 1 < keywordLength; ++i )
+      if ( lower( candidate[i] ) != keyword[i] )
+        return false;
+    return true;
+  }
+
+  bool scanScalar ( const char *text, std::size_t textLength,
+                    const char *keyword, std::size_t keywordLength, bool caseInsensitive )
+  {
+    if ( keywordLength > textLength )
+      return false;
+
+    const char *candidate = text;
+    const char *lastCandidate = text + ( textLength - keywordLength ) + 1;
+    const char tail = keyword[keywordLength - 1];
+
+    if ( !caseInsensitive )
+    {
+      while ( candidate < lastCandidate )
+      {
+        candidate = static_cast< const char * >(
+                std::memchr( candidate, keyword[0], static_cast< std::size_t >( lastCandidate - candidate ) ) );
+        if ( nullptr == candidate )
+          return false;
+        if ( candidate[keywordLength - 1] == tail && verify( candidate, keyword, keywordLength, false ) )
+          return true;
+        ++candidate;
+      }
+      return false;
+    }
+
+    for ( ; candidate < lastCandidate; ++candidate )
+      if ( lower( candidate[0] ) == keyword[0] && lower( candidate[keywordLength - 1] ) == tail
+           && verify( candidate, keyword, keywordLength, true ) )
+        return true;
+    return false;
+  }
+
+#if SUBSTRINGSCANNER_X86
+  __attribute__(( target( "sse2" ) ))
+  bool scanSse2 ( const char *text, std::size_t textLength,
+                  const char *keyword, std::size_t keywordLength, bool caseInsensitive )
+  {
+    if ( keywordLength > textLength )
+      return false;
+
+    const char head = keyword[0];
+    const char tail = keyword[keywordLength - 1];
+    // the alternative case of the boundary bytes, the same byte again when matching the case
+    const __m128i firstLower = _mm_set1_epi8( head );
+    const __m128i firstUpper = _mm_set1_epi8( caseInsensitive ? upper( head ) : head );
+    const __m128i lastLower = _mm_set1_epi8( tail );
+    const __m128i lastUpper = _mm_set1_epi8( caseInsensitive ? upper( tail ) : tail );
+
+    std::size_t position = 0;
+    for ( ; position + keywordLength - 1 + 16 <= textLength; position += 16 )
+    {
+      const __m128i blockFirst = _mm_loadu_si128( reinterpret_cast< const __m128i * >( text + position ) );
+      const __m128i blockLast = _mm_loadu_si128(
+              reinterpret_cast< const __m128i * >( text + position + keywordLength - 1 ) );
+      const __m128i equalFirst = _mm_or_si128( _mm_cmpeq_epi8( blockFirst, firstLower ),
+                                               _mm_cmpeq_epi8( blockFirst, firstUpper ) );
+      const __m128i equalLast = _mm_or_si128( _mm_cmpeq_epi8( blockLast, lastLower ),
+                                              _mm_cmpeq_epi8( blockLast, lastUpper ) );
+      unsigned mask = static_cast< unsigned >( _mm_movemask_epi8( _mm_and_si128( equalFirst, equalLast ) ) );
+      while ( 0 != mask )
+      {
+        const unsigned offset = static_cast< unsigned >( __builtin_ctz( mask ) );
+        if ( verify( text + position + offset, keyword, keywordLength, caseInsensitive ) )
+          return true;
+        mask &= mask - 1;
+      }
+    }
+
+    return scanScalar( text + position, textLength - position, keyword, keywordLength, caseInsensitive );
+  }
+
+  __attribute__(( target( "avx2" ) ))
+  bool scanAvx2 ( const char *text, std::size_t textLength,
+                  const char *keyword, std::size_t keywordLength, bool caseInsensitive )
+  {
+    if ( keywordLength > textLength )
+      return false;
+
+    const char head = keyword[0];
+    const char tail = keyword[keywordLength - 1];
+    const __m256i firstLower = _mm256_set1_epi8( head );
+    const __m256i firstUpper = _mm256_set1_epi8( caseInsensitive ? upper( head ) : head );
+    const __m256i lastLower = _mm256_set1_epi8( tail );
+    const __m256i lastUpper = _mm256_set1_epi8( caseInsensitive ? upper( tail ) : tail );
+
+    std::size_t position = 0;
+    for ( ; position + keywordLength - 1 + 32 <= textLength; position += 32 )
+    {
+      const __m256i blockFirst = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( text + position ) );
+      const __m256i blockLast = _mm256_loadu_si256(
+              reinterpret_cast< const __m256i * >( text + position + keywordLength - 1 ) );
+      const __m256i equalFirst = _mm256_or_si256( _mm256_cmpeq_epi8( blockFirst, firstLower ),
+                                                  _mm256_cmpeq_epi8( blockFirst, firstUpper ) );
+      const __m256i equalLast = _mm256_or_si256( _mm256_cmpeq_epi8( blockLast, lastLower ),
+                                                 _mm256_cmpeq_epi8( blockLast, lastUpper ) );
+      unsigned mask = static_cast< unsigned >( _mm256_movemask_epi8( _mm256_and_si256( equalFirst, equalLast ) ) );
+      while ( 0 != mask )
+      {
+        const unsigned offset = static_cast< unsigned >( __builtin_ctz( mask ) );
+        if ( verify( text + position + offset, keyword, keywordLength, caseInsensitive ) )
+          return true;
+        mask &= mask - 1;
+      }
+    }
+
+    // the 16 bytes kernel still covers most of a short tail
+    return scanSse2( text + position, textLength - position, keyword, keywordLength, caseInsensitive );
+  }
+#endif
+} // namespace
+
+Qustodio::SubstringScanner::SubstringScanner ( const std::vector< std::string > &keywords, bool caseInsensitive,
+                                               Kernel kernel )
+        : caseInsensitive( caseInsensitive )
+{
+  for ( auto &&keyword: keywords )
+  {
+    if ( keyword.empty() )
+      continue;
+    this->keywords.push_back( keyword );
+    if ( caseInsensitive )
+      for ( auto &&character: this->keywords.back() )
+        character = lower( character );
+  }
+
+  const Kernel best = bestKernel();
+  if ( Kernel::Automatic == kernel || static_cast< int >( kernel ) > static_cast< int >( best ) )
+    kernel = best;
+
+  this->selectedKernel = kernel;
+  switch ( kernel )
+  {
+#if SUBSTRINGSCANNER_X86
+    case Kernel::Avx2:
+      this->scan = & scanAvx2;
+      break;
+    case Kernel::Sse2:
+      this->scan = & scanSse2;
+      break;
+#endif
+    default:
+      this->selectedKernel = Kernel::Scalar;
+      this->scan = & scanScalar;
+      break;
+  }
+}
+
+bool Qustodio::SubstringScanner::matches ( StringRef text ) const
+{
+  for ( auto &&keyword: this->keywords )
+    if ( this->scan( text.data(), text.size(), keyword.data(), keyword.size(), this->caseInsensitive ) )
+      return true;
+  return false;
+}
+
+bool Qustodio::SubstringScanner::matchesKeyword ( StringRef text, std::size_t index ) const
+{
+  const std::string &keyword = this->keywords[index];
+  return this->scan( text.data(), text.size(), keyword.data(), keyword.size(), this->caseInsensitive );
+}
+
+Qustodio::SubstringScanner::Kernel Qustodio::SubstringScanner::bestKernel ()
+{
+#if SUBSTRINGSCANNER_X86
+  static const Kernel best = __builtin_cpu_supports( "avx2" ) ? Kernel::Avx2
+                             : ( __builtin_cpu_supports( "sse2" ) ? Kernel::Sse2 : Kernel::Scalar );
+  return best;
+#else
+  return Kernel::Scalar;
+#endif
+}
@@ -0,0 +1,105 @@
+/** @file
+ * @brief Substring Scanner
+ *
+ * This file contains the vectorized substring search used by the filters for short keyword lists
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref SubstringScanner_legal_note_sec
+ *
+ * @section SubstringScanner_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section SubstringScanner_intro_sec Introduction
+ *
+ * For a handful of keywords an automaton is overkill: every keyword is looked for directly with a SIMD kernel. The
+ * kernel broadcasts the first and the last byte of the keyword, compares them against 16 (SSE2) or 32 (AVX2) positions
+ * of the text at once and only verifies the whole keyword on the positions where both bytes match. The kernel is
+ * picked once at runtime from the CPUID flags, with a portable scalar fallback.
+ *
+ * @section SubstringScanner_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section SubstringScanner_install_sec Use
+ *
+ * @subsection SubstringScanner_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef SUBSTRINGSCANNER_HPP
+#define SUBSTRINGSCANNER_HPP
+
+#include "StringRef.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/*! \class SubstringScanner SubstringScanner.hpp "SubstringScanner.hpp"
+ *  \brief SIMD search of a short list of keywords.
+ *
+ * Immutable once built, so a single instance can be shared by every worker of a #ComposerPool.
+ */
+  class SubstringScanner
+  {
+    public:
+    /**
+     * @brief Instruction sets of the scan kernel
+     */
+    enum class Kernel
+    {
+      Automatic, //< The best one supported by the CPU
+      Scalar,    //< Portable memchr based search
+      Sse2,      //< 16 bytes per step
+      Avx2       //< 32 bytes per step
+    };
+
+    /**
+     * @brief Prepares the keywords for the scan
+     * @param keywords [in] the keywords to look for, empty keywords are ignored
+     * @param caseInsensitive [in] true to match ASCII letters regardless of their case
+     * @param kernel [in] the kernel to use, downgraded when the CPU doesn't support it
+     */
+    explicit SubstringScanner ( const std::vector< std::string > &keywords, bool caseInsensitive = false,
+                                Kernel kernel = Kernel::Automatic );
+
+    /**
+     * @brief Checks whether any keyword occurs in #text
+     */
+    bool matches ( StringRef text ) const;
+
+    /**
+     * @brief Checks whether the keyword #index occurs in #text
+     */
+    bool matchesKeyword ( StringRef text, std::size_t index ) const;
+
+    std::size_t keywordCount () const { return keywords.size(); } //< Number of keywords, without the empty ones
+
+    Kernel kernel () const { return selectedKernel; } //< The kernel actually used
+
+    /**
+     * @brief The best kernel supported by the running CPU
+     */
+    static Kernel bestKernel ();
+
+    /**
+     * @brief Signature of the scan kernels
+     */
+    typedef bool ( *ScanFunction ) ( const char *text, std::size_t textLength,
+                                     const char *keyword, std::size_t keywordLength, bool caseInsensitive );
+
+    private:
+    std::vector< std::string > keywords; //< The keywords, lower cased when #caseInsensitive
+    bool caseInsensitive;                //< Ignore the case of ASCII letters
+    Kernel selectedKernel;               //< The kernel #scan implements
+    ScanFunction scan;                   //< The scan kernel
+  };
+
+} // namespace Qustodio
+
+#endif // SUBSTRINGSCANNER_HPP
@@ -0,0 +1,261 @@
+/** @file
+ * @brief Browsing Benchmark
+ *
+ * This file contains the benchmark suite of the ingestion, the filters and the thread pool
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref BrowsingBenchmark_legal_note_sec
+ *
+ * @section BrowsingBenchmark_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section BrowsingBenchmark_intro_sec Introduction
+ *
+ * Measures, over logs written by the #LogGenerator:
+ *  - CommonStorageComponent::readFromFile for several sizes, device counts and url lengths
+ *  - FilterEvents::filterBadWords for several match rates and expressions
+ *  - the post and enqueue throughput of the #ComposerPool for several thread counts
+ *
+ * Every line reports events (or tasks) per second and MB per second where bytes are read. The ingestion and filter
+ * lines add the median and the slowest of their few repeated runs, the pool lines the p50/p99 latency of every single
+ * task, from its submission to its start.
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I.. ../[A-Z]*.cpp LogGenerator.cpp BrowsingBenchmark.cpp -o BrowsingBenchmark
+ *
+ * Run `./BrowsingBenchmark [events]` for the suite, 200000 events per log by default, or
+ * `./BrowsingBenchmark generate <file> [events] [devices] [matchRate] [meanUrlLength]` to only write a log.
+ *
+ * @section BrowsingBenchmark_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section BrowsingBenchmark_install_sec Use
+ *
+ * @subsection BrowsingBenchmark_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#include "LogGenerator.hpp"
+
+#include "CommonStorageComponent.hpp"
+#include "ComposerPool.hpp"
+#include "FilterEvents.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  const char *const logFile = "browsing_benchmark.log"; //< The log written for every ingestion profile
+  const int repetitions = 5;                             //< Runs of every ingestion and filter measure
+
+  double secondsSince ( Clock::time_point start )
+  {
+    return std::chrono::duration< double >( Clock::now() - start ).count();
+  }
+
+  /**
+   * @brief The #fraction quantile of #samples, which are sorted in place
+   */
+  double quantile ( std::vector< double > &samples, double fraction )
+  {
+    if ( samples.empty() )
+      return 0.0;
+    std::sort( samples.begin(), samples.end() );
+    const std::size_t index = static_cast< std::size_t >( fraction * static_cast< double >( samples.size() - 1 ) + 0.5 );
+    return samples[index];
+  }
+
+  /**
+   * @brief Prints a result line, the rates are taken at the median run
+   *
+   * With #repetitions runs there are no tail quantiles to speak of, so the slowest run is reported as such.
+   * @param seconds [in,out] the time of every run
+   */
+  void report ( const std::string &name, std::size_t events, std::size_t bytes, std::vector< double > &seconds )
+  {
+    const double median = quantile( seconds, 0.50 );
+    const double slowest = quantile( seconds, 1.0 );
+    std::printf( "%-44s %12.0f events/s %9.1f MB/s   med %9.3f ms   max %9.3f ms\n", name.c_str(),
+                 static_cast< double >( events ) / median, static_cast< double >( bytes ) / median / 1e6,
+                 median * 1e3, slowest * 1e3 );
+  }
+
+  std::size_t fileSize ( const char *file )
+  {
+    std::ifstream in( file, std::ios::binary | std::ios::ate );
+    return in.is_open() ? static_cast< std::size_t >( in.tellg() ) : 0;
+  }
+
+  void benchmarkIngestion ( std::size_t events )
+  {
+    struct
+    {
+      const char *name;
+      std::size_t events;
+      std::size_t devices;
+      std::size_t meanUrlLength;
+    } const profiles[] = { { "readFromFile small", events / 10, 16, 40 },
+                           { "readFromFile", events, 16, 40 },
+                           { "readFromFile 4096 devices", events, 4096, 40 },
+                           { "readFromFile long urls", events, 16, 160 } };
+
+    for ( auto &&shape: profiles )
+    {
+      Qustodio::LogProfile profile;
+      profile.events = shape.events;
+      profile.devices = shape.devices;
+      profile.meanUrlLength = shape.meanUrlLength;
+      if ( !Qustodio::LogGenerator( profile ).writeFile( logFile ) )
+      {
+        std::cerr << "Can't write " << logFile << std::endl;
+        return;
+      }
+
+      std::vector< double > seconds;
+      for ( int run = 0; run < repetitions; ++run )
+      {
+        const Clock::time_point start = Clock::now();
+        Qustodio::CommonStorageComponent component;
+        component.readFromFile( logFile );
+        seconds.push_back( secondsSince( start ) );
+      }
+      report( std::string( shape.name ) + " (" + std::to_string( shape.events ) + ")", shape.events,
+              fileSize( logFile ), seconds );
+    }
+  }
+
+  void benchmarkFilters ( std::size_t events )
+  {
+    const double matchRates[] = { 0.01, 0.1, 0.5 };
+    struct
+    {
+      const char *regex;
+      Qustodio::FilterEvents::RegexEngine engine;
+    } const filters[] = { { ".*(porn|xxx).*", Qustodio::FilterEvents::RegexEngine::Std },
+                          { "(p.rn|xxx)", Qustodio::FilterEvents::RegexEngine::Std },
+                          { "(p.rn|xxx)", Qustodio::FilterEvents::RegexEngine::Dfa } };
+
+    for ( double matchRate: matchRates )
+    {
+      Qustodio::LogProfile profile;
+      profile.events = events;
+      profile.matchRate = matchRate;
+      if ( !Qustodio::LogGenerator( profile ).writeFile( logFile ) )
+      {
+        std::cerr << "Can't write " << logFile << std::endl;
+        return;
+      }
+
+      Qustodio::CommonStorageComponent component;
+      component.readFromFile( logFile );
+      const std::shared_ptr< const Qustodio::EventStore > events = component.Events();
+      const Qustodio::EventStore &store = * events;
+      std::size_t urlBytes = 0;
+      for ( std::size_t i = 0; i < store.size(); ++i )
+        urlBytes += store.url( i ).size();
+
+      for ( auto &&filter: filters )
+      {
+        Qustodio::FilterEvents filterEvents( component, "", filter.engine );
+        std::vector< double > seconds;
+        for ( int run = 0; run < repetitions; ++run )
+        {
+          const Clock::time_point start = Clock::now();
+          filterEvents.filterBadWords( filter.regex );
+          seconds.push_back( secondsSince( start ) );
+        }
+        char name[64];
+        std::snprintf( name, sizeof( name ), "filterBadWords %s %s %.0f%%", filter.regex,
+                       Qustodio::FilterEvents::RegexEngine::Dfa == filter.engine ? "dfa" : "std", matchRate * 100 );
+        report( name, store.size(), urlBytes, seconds );
+      }
+    }
+  }
+
+  /**
+   * @brief Runs #tasks empty tasks through a pool of #threads workers, with post or with enqueue
+   */
+  void benchmarkPool ( std::size_t threads, std::size_t tasks, bool withFuture )
+  {
+    std::vector< double > latencies( tasks );
+    std::vector< std::future< void >> futures;
+    Qustodio::ComposerPool pool( threads );
+
+    const Clock::time_point start = Clock::now();
+    for ( std::size_t i = 0; i < tasks; ++i )
+    {
+      const Clock::time_point submitted = Clock::now();
+      double *latency = &latencies[i];
+      auto task = [ submitted, latency ] ()
+      {
+        * latency = std::chrono::duration< double >( Clock::now() - submitted ).count();
+      };
+      if ( withFuture )
+        futures.push_back( pool.enqueue( task ) );
+      else
+        pool.post( task );
+    }
+    pool.wait_until_nothing_in_flight();
+    const double elapsed = secondsSince( start );
+
+    const double p50 = quantile( latencies, 0.50 );
+    const double p99 = quantile( latencies, 0.99 );
+    char name[64];
+    std::snprintf( name, sizeof( name ), "ComposerPool %s %zu threads", withFuture ? "enqueue" : "post", threads );
+    std::printf( "%-44s %12.0f tasks/s  %9s        p50 %9.3f us   p99 %9.3f us\n", name,
+                 static_cast< double >( tasks ) / elapsed, "", p50 * 1e6, p99 * 1e6 );
+  }
+
+  int generate ( int argc, char **argv )
+  {
+    if ( argc < 3 )
+    {
+      std::cerr << "Usage: " << argv[0] << " generate <file> [events] [devices] [matchRate] [meanUrlLength]"
+                << std::endl;
+      return 1;
+    }
+    Qustodio::LogProfile profile;
+    if ( argc > 3 )
+      profile.events = std::strtoull( argv[3], nullptr, 10 );
+    if ( argc > 4 )
+      profile.devices = std::strtoull( argv[4], nullptr, 10 );
+    if ( argc > 5 )
+      profile.matchRate = std::strtod( argv[5], nullptr );
+    if ( argc > 6 )
+      profile.meanUrlLength = std::strtoull( argv[6], nullptr, 10 );
+    return Qustodio::LogGenerator( profile ).writeFile( argv[2] ) ? 0 : 1;
+  }
+} // namespace
+
+int main ( int argc, char **argv )
+{
+  if ( argc > 1 && std::string( argv[1] ) == "generate" )
+    return generate( argc, argv );
+
+  const std::size_t events = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 200000;
+
+  benchmarkIngestion( events );
+  benchmarkFilters( events );
+  for ( std::size_t threads: { 1, 2, 4, 8 } )
+  {
+    benchmarkPool( threads, events, false );
+    benchmarkPool( threads, events, true );
+  }
+
+  std::remove( logFile );
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include "LogGenerator.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+  const char *const words[] = { "news", "mail", "shop", "video", "sport", "maps", "docs", "games", "search", "blog" };
+  const char *const hosts[] = { "www.", "m.", "cdn.", "static.", "" };
+  const char *const domains[] = { ".com", ".net", ".org", ".es", ".io" };
+
+  template < class T, std::size_t N >
+  std::uint32_t countOf ( T ( & )[N] )
+  {
+    return static_cast< std::uint32_t >( N );
+  }
+} // namespace
+
+Qustodio::LogGenerator::LogGenerator ( const LogProfile &profile )
+        : profile( profile ), random( profile.seed )
+{
+}
+
+const std::vector< std::string > &Qustodio::LogGenerator::badWords ()
+{
+  static const std::vector< std::string > planted = { "porn", "xxx" };
+  return planted;
+}
+
+std::uint32_t Qustodio::LogGenerator::draw ( std::uint32_t bound )
+{
+  return bound > 1 ? static_cast< std::uint32_t >( this->random() % bound ) : 0u;
+}
+
+bool Qustodio::LogGenerator::chance ( double probability )
+{
+  // 32 bits of the generator, a std distribution would differ between standard libraries
+  return this->random() < probability * 4294967296.0;
+}
+
+void Qustodio::LogGenerator::nextUrl ( std::string &url )
+{
+  const std::size_t shortest = 16;
+  const std::size_t mean = this->profile.meanUrlLength > shortest ? this->profile.meanUrlLength : shortest;
+  const std::size_t longest = this->profile.maxUrlLength > mean ? this->profile.maxUrlLength : mean;
+
+  std::size_t length = shortest + this->draw( static_cast< std::uint32_t >( 2 * ( mean - shortest ) + 1 ) );
+  if ( this->chance( this->profile.longUrlRate ) )
+    length = mean + this->draw( static_cast< std::uint32_t >( longest - mean + 1 ) );
+
+  url = hosts[this->draw( countOf( hosts ) )];
+  url += words[this->draw( countOf( words ) )];
+  url += std::to_string( this->draw( 1000 ) );
+  url += domains[this->draw( countOf( domains ) )];
+
+  // the bad word goes in one of the first path segments, or in the last one of a short url
+  const bool planted = this->chance( this->profile.matchRate );
+  const std::size_t plantAt = planted ? this->draw( 4 ) : ~std::size_t( 0 );
+  bool missing = planted;
+  for ( std::size_t segment = 0; url.size() < length || missing; ++segment )
+  {
+    url += '/';
+    if ( missing && ( segment == plantAt || url.size() >= length ) )
+    {
+      url += badWords()[this->draw( static_cast< std::uint32_t >( badWords().size() ) )];
+      missing = false;
+    }
+    else
+      url += words[this->draw( countOf( words ) )];
+  }
+  // the words can't form a bad word, so cutting keeps the match rate exact
+  if ( !planted && url.size() > length )
+    url.resize( length );
+}
+
+std::size_t Qustodio::LogGenerator::write ( std::ostream &out )
+{
+  std::string url;
+  std::string record;
+  char device[24];
+  std::size_t written = 0;
+  std::int64_t timestamp = this->profile.firstTimestamp;
+  const std::uint32_t devices = static_cast< std::uint32_t >( this->profile.devices > 0 ? this->profile.devices : 1 );
+
+  for ( std::size_t i = 0; i < this->profile.events; ++i )
+  {
+    this->nextUrl( url );
+    const std::uint32_t id = this->draw( devices );
+    std::snprintf( device, sizeof( device ), "00:11:22:%02x:%02x:%02x", ( id >> 16 ) & 0xff, ( id >> 8 ) & 0xff,
+                   id & 0xff );
+    timestamp += this->draw( 3 );
+
+    record = "url: ";
+    record += url;
+    record += "\ndevice: ";
+    record += device;
+    record += "\ntimestamp: ";
+    record += std::to_string( timestamp );
+    record += '\n';
+
+    out.write( record.data(), static_cast< std::streamsize >( record.size() ) );
+    written += record.size();
+  }
+  return written;
+}
+
+bool Qustodio::LogGenerator::writeFile ( const std::string &fileToWrite )
+{
+  std::ofstream out( fileToWrite, std::ios::binary | std::ios::trunc );
+  if ( !out.is_open() )
+    return false;
+  this->write( out );
+  out.close();
+  return !out.fail();
+}
@@ -0,0 +1,110 @@
+/** @file
+ * @brief Log Generator
+ *
+ * This file contains the deterministic generator of synthetic browsing logs used by the benchmarks
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref LogGenerator_legal_note_sec
+ *
+ * @section LogGenerator_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section LogGenerator_intro_sec Introduction
+ *
+ * Writes logs in the `url:`/`device:`/`timestamp:` format of the real ones, one field per line. The size, the distribution
+ * of the url lengths, the number of devices and the share of urls holding a bad word are set with a #LogProfile. Only
+ * std::mt19937 draws are used, whose sequence is fixed by the standard, so a profile gives the same bytes everywhere.
+ *
+ * @section LogGenerator_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section LogGenerator_install_sec Use
+ *
+ * @subsection LogGenerator_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef LOGGENERATOR_HPP
+#define LOGGENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Qustodio
+{
+
+/**
+ * @brief The shape of a synthetic log
+ */
+  struct LogProfile
+  {
+    std::size_t events = 100000;             //< Number of records
+    std::size_t devices = 16;                //< Number of distinct MAC addresses
+    std::size_t meanUrlLength = 40;          //< Mean length of the common urls
+    std::size_t maxUrlLength = 512;          //< Longest url of the tail
+    double longUrlRate = 0.02;               //< Share of urls drawn up to #maxUrlLength
+    double matchRate = 0.05;                 //< Share of urls holding one of LogGenerator::badWords
+    std::int64_t firstTimestamp = 1545573000; //< Timestamp of the first record, the next ones grow by 0 to 2 seconds
+    std::uint32_t seed = 2018;               //< Seed of the generator
+  };
+
+/*! \class LogGenerator LogGenerator.hpp "LogGenerator.hpp"
+ *  \brief Deterministic writer of synthetic browsing logs.
+ *
+ * Common urls are uniformly long around LogProfile::meanUrlLength, a LogProfile::longUrlRate tail is uniformly long
+ * up to LogProfile::maxUrlLength. Every record picks one of the devices uniformly.
+ */
+  class LogGenerator
+  {
+    public:
+    explicit LogGenerator ( const LogProfile &profile );
+
+    /**
+     * @brief Writes the whole log
+     * @param out [in,out] the stream receiving the log
+     * @return the number of bytes written
+     */
+    std::size_t write ( std::ostream &out );
+
+    /**
+     * @brief Writes the whole log to a file
+     * @param fileToWrite [in] the file to write
+     * @return false when the file can't be written
+     */
+    bool writeFile ( const std::string &fileToWrite );
+
+    /**
+     * @brief The words planted in LogProfile::matchRate of the urls
+     */
+    static const std::vector< std::string > &badWords ();
+
+    private:
+    /**
+     * @brief Draws the next url
+     */
+    void nextUrl ( std::string &url );
+
+    /**
+     * @brief Draws an integer in [0, bound)
+     */
+    std::uint32_t draw ( std::uint32_t bound );
+
+    /**
+     * @brief Draws true with #probability
+     */
+    bool chance ( double probability );
+
+    LogProfile profile;   //< The shape of the log
+    std::mt19937 random;  //< The only source of randomness
+  };
+
+} // namespace Qustodio
+
+#endif // LOGGENERATOR_HPP
@@ -0,0 +1,152 @@
+/** @file
+ * @brief Url Scan Benchmark
+ *
+ * This file contains the microbenchmark of the url keyword filters
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref UrlScanBenchmark_legal_note_sec
+ *
+ * @section UrlScanBenchmark_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section UrlScanBenchmark_intro_sec Introduction
+ *
+ * Compares, over the same synthetic urls, the per event std::regex of FilterEvents::filterUrl with a precompiled
+ * std::regex, std::string::find, the #KeywordMatcher automaton and every kernel of the #SubstringScanner.
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I.. ../KeywordMatcher.cpp ../SubstringScanner.cpp UrlScanBenchmark.cpp -o UrlScanBenchmark
+ *
+ * @section UrlScanBenchmark_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section UrlScanBenchmark_install_sec Use
+ *
+ * @subsection UrlScanBenchmark_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#include "KeywordMatcher.hpp"
+#include "SubstringScanner.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const std::vector< std::string > badWords = { "porn", "xxx" };
+
+  /**
+   * @brief Deterministic urls, about one in ten holds a bad word
+   */
+  std::vector< std::string > makeUrls ( std::size_t count )
+  {
+    static const char *const words[] = { "news", "mail", "shop", "video", "sport", "maps", "docs", "games" };
+    static const char *const hosts[] = { "www.", "m.", "cdn.", "" };
+    std::mt19937 random( 2018 );
+    std::vector< std::string > urls;
+    urls.reserve( count );
+
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      std::string url = "https://";
+      url += hosts[random() % 4];
+      url += words[random() % 8];
+      url += std::to_string( random() % 1000 );
+      url += ".com/";
+      const std::size_t segments = 1 + random() % 4;
+      for ( std::size_t segment = 0; segment < segments; ++segment )
+      {
+        url += ( random() % 40 == 0 ) ? badWords[random() % badWords.size()] : words[random() % 8];
+        url += '/';
+      }
+      urls.push_back( url );
+    }
+    return urls;
+  }
+
+  /**
+   * @brief Runs #filter over #urls and prints the time per url
+   */
+  void measure ( const char *name, const std::vector< std::string > &urls,
+                 const std::function< bool ( const std::string & ) > &filter )
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t matches = 0;
+    for ( auto &&url: urls )
+      if ( filter( url ) )
+        ++matches;
+    const auto elapsed = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start );
+
+    std::printf( "%-28s %10.1f ns/url %12.0f urls/s %8zu matches\n", name, elapsed.count() / urls.size(),
+                 urls.size() * 1e9 / elapsed.count(), matches );
+  }
+} // namespace
+
+int main ( void )
+{
+  const std::vector< std::string > urls = makeUrls( 200000 );
+  // the per event regex is too slow for the whole set
+  const std::vector< std::string > fewUrls( urls.begin(), urls.begin() + 5000 );
+  const std::string regexString = ".*(porn|xxx).*";
+
+  measure( "regex per event (filterUrl)", fewUrls, [ &regexString ] ( const std::string &url )
+  {
+    std::regex strRegex( regexString );
+    std::smatch resultUrl;
+    std::regex_search( url, resultUrl, strRegex );
+    return resultUrl[1].length() > 0;
+  } );
+
+  const std::regex compiled( regexString );
+  measure( "regex compiled once", urls, [ &compiled ] ( const std::string &url )
+  {
+    std::smatch resultUrl;
+    std::regex_search( url, resultUrl, compiled );
+    return resultUrl[1].length() > 0;
+  } );
+
+  measure( "std::string::find", urls, [] ( const std::string &url )
+  {
+    for ( auto &&word: badWords )
+      if ( url.find( word ) != std::string::npos )
+        return true;
+    return false;
+  } );
+
+  const Qustodio::KeywordMatcher matcher( badWords );
+  measure( "KeywordMatcher", urls, [ &matcher ] ( const std::string &url ) { return matcher.matches( url ); } );
+
+  typedef Qustodio::SubstringScanner::Kernel Kernel;
+  const struct
+  {
+    const char *name;
+    Kernel kernel;
+  } kernels[] = { { "SubstringScanner scalar", Kernel::Scalar },
+                  { "SubstringScanner sse2", Kernel::Sse2 },
+                  { "SubstringScanner avx2", Kernel::Avx2 } };
+  for ( auto &&kernel: kernels )
+  {
+    const Qustodio::SubstringScanner scanner( badWords, false, kernel.kernel );
+    if ( scanner.kernel() != kernel.kernel )
+      continue;
+    measure( kernel.name, urls, [ &scanner ] ( const std::string &url ) { return scanner.matches( url ); } );
+  }
+
+  const Qustodio::SubstringScanner insensitive( badWords, true );
+  measure( "SubstringScanner nocase", urls, [ &insensitive ] ( const std::string &url )
+  {
+    return insensitive.matches( url );
+  } );
+
+  return 0;
+}
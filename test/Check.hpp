@@ -0,0 +1,75 @@
+/** @file
+ * @brief Check
+ *
+ * This file contains the failure counter shared by the test programs
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref Check_legal_note_sec
+ *
+ * @section Check_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section Check_intro_sec Introduction
+ *
+ * Every test program of this folder is a plain executable: it calls #Qustodio::Check::expect for every condition,
+ * which reports the failed ones on stderr, and returns #Qustodio::Check::report from main, non zero when any failed.
+ *
+ * @section Check_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section Check_install_sec Use
+ *
+ * @subsection Check_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+#include <string>
+
+namespace Qustodio
+{
+  namespace Check
+  {
+    /**
+     * @brief Number of failed conditions of the program
+     */
+    inline unsigned &failures ()
+    {
+      static unsigned count = 0;
+      return count;
+    }
+
+    /**
+     * @brief Reports #what on stderr when #condition is false
+     * @return #condition
+     */
+    inline bool expect ( bool condition, const std::string &what )
+    {
+      if ( !condition )
+      {
+        ++failures();
+        std::fprintf( stderr, "FAILED: %s\n", what.c_str() );
+      }
+      return condition;
+    }
+
+    /**
+     * @brief Prints the outcome of the test #name
+     * @return the exit status of the program, non zero when a condition failed
+     */
+    inline int report ( const char *name )
+    {
+      std::printf( "%s: %s\n", name, 0 == failures() ? "passed" : "FAILED" );
+      return 0 == failures() ? 0 : 1;
+    }
+  } // namespace Check
+
+} // namespace Qustodio
+
+#endif // CHECK_HPP
@@ -0,0 +1,279 @@
+/** @file
+ * @brief Compressed File Test
+ *
+ * This file contains the checks of the reads of gzip compressed logs against the reads of the same plain logs
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref CompressedFileTest_legal_note_sec
+ *
+ * @section CompressedFileTest_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section CompressedFileTest_intro_sec Introduction
+ *
+ * Writes a synthetic log of several batches of decompressed blocks with the #LogGenerator, adds the records the
+ * parser closes early, such as empty lines, `-` list markers, unknown keys and an url longer than a block, and
+ * gzips it with zlib, as a single member and as several members cut in the middle of a line. Checks that
+ * CommonStorageComponent::readFromFile and CommonStorageComponent::streamFromFile read the same events from the
+ * compressed files as from the plain one, that the parse stage records the decompressed bytes, and that truncated
+ * and unsupported files are reported instead of read partially.
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -pthread -DCOMPRESSEDFILE_ZLIB=1 -I.. -I../benchmark ../[A-Z]*.cpp ../benchmark/LogGenerator.cpp CompressedFileTest.cpp -lz -o CompressedFileTest
+ *
+ * @section CompressedFileTest_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section CompressedFileTest_install_sec Use
+ *
+ * @subsection CompressedFileTest_step1 Requirements
+ * Requires C++11 and zlib to use it correctly
+ */
+
+#include "Check.hpp"
+#include "CommonStorageComponent.hpp"
+#include "CompressedFile.hpp"
+#include "LogGenerator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+#include <zlib.h>
+
+namespace
+{
+  const std::size_t logEvents = 220000;      //< Records of the generated log, about three batches of blocks
+  const std::size_t longUrlLength = 3 << 20; //< Url spanning several decompressed blocks
+  const std::size_t memberCount = 3;         //< Members of the multi-member file
+
+  typedef std::tuple< std::string, std::string, std::int64_t > Event; //< Url, device and timestamp of an event
+
+  /**
+   * @brief A new empty temporary file
+   */
+  std::string temporaryFile ()
+  {
+    char path[] = "/tmp/CompressedFileTestXXXXXX";
+    const int descriptor = ::mkstemp( path );
+    if ( descriptor < 0 )
+    {
+      std::perror( "CompressedFileTest" );
+      std::exit( 2 );
+    }
+    ::close( descriptor );
+    return path;
+  }
+
+  void writeFile ( const std::string &path, const std::string &content )
+  {
+    std::ofstream out( path, std::ios::binary | std::ios::trunc );
+    out.write( content.data(), static_cast< std::streamsize >( content.size() ) );
+    if ( !out )
+    {
+      std::perror( "CompressedFileTest" );
+      std::exit( 2 );
+    }
+  }
+
+  /**
+   * @brief Gzips #content into #path as #members members, cut at the same distance whatever the lines
+   */
+  void writeGzip ( const std::string &path, const std::string &content, std::size_t members )
+  {
+    const std::size_t memberSize = content.size() / members + 1;
+    for ( std::size_t m = 0; m != members; ++m )
+    {
+      // every gzopen in append mode starts a new member
+      gzFile file = gzopen( path.c_str(), 0 == m ? "wb" : "ab" );
+      const std::size_t first = std::min( content.size(), m * memberSize );
+      const std::size_t size = std::min( content.size() - first, memberSize );
+      if ( nullptr == file || ( size > 0 && 0 == gzwrite( file, content.data() + first, static_cast< unsigned >( size ) ) ) )
+      {
+        std::perror( "CompressedFileTest" );
+        std::exit( 2 );
+      }
+      gzclose( file );
+    }
+  }
+
+  /**
+   * @brief The plain log: generated records around the records the parser closes early
+   */
+  std::string plainLog ()
+  {
+    Qustodio::LogProfile profile;
+    profile.events = logEvents / 2;
+    std::ostringstream log;
+    Qustodio::LogGenerator( profile ).write( log );
+
+    log << "\n\n"
+           "- url: http://list.example.com/first\n"
+           "  device: 00:11:22:aa:bb:cc\n"
+           "- url: http://list.example.com/second\n"
+           "device: 00:11:22:aa:bb:cd\n"
+           "browser: unknown key\n"
+           "timestamp: 1545573999\n"
+           "url: http://repeated.example.com/a\n"
+           "url: http://repeated.example.com/b\n"
+           "timestamp: 1545574000\n"
+           "\n"
+           "url: http://long.example.com/" << std::string( longUrlLength, 'x' ) << "\n"
+           "device: 00:11:22:aa:bb:ce\n"
+           "timestamp: 1545574001\n";
+
+    profile.events = logEvents - profile.events;
+    profile.firstTimestamp = 1545574002;
+    profile.seed = 2019;
+    Qustodio::LogGenerator( profile ).write( log );
+
+    // a last record without its newline
+    log << "url: http://last.example.com/\ndevice: 00:11:22:aa:bb:cf\ntimestamp: 1545999999";
+    return log.str();
+  }
+
+  void append ( const Qustodio::EventStore &store, std::vector< Event > &events )
+  {
+    for ( std::size_t i = 0; i < store.size(); ++i )
+      events.emplace_back( store.url( i ).str(), store.device( i ).str(), store.timestamp( i ) );
+  }
+
+  /**
+   * @brief The events #readFromFile publishes for #path, in order
+   */
+  std::vector< Event > readEvents ( const std::string &path )
+  {
+    Qustodio::CommonStorageComponent component;
+    component.readFromFile( path );
+    const std::shared_ptr< const Qustodio::EventVersion > published = component.Published();
+    std::vector< Event > events;
+    for ( std::size_t s = 0; s != published->segmentCount(); ++s )
+      append( * published->segment( s ), events );
+    return events;
+  }
+
+  /**
+   * @brief The events #streamFromFile pushes for #path, in order
+   */
+  std::vector< Event > streamEvents ( const std::string &path )
+  {
+    Qustodio::CommonStorageComponent component;
+    Qustodio::BoundedChannel< Qustodio::EventStore > channel;
+    std::thread producer( [ &component, &channel, &path ] () { component.streamFromFile( path, channel ); } );
+    std::vector< Event > events;
+    Qustodio::EventStore batch;
+    while ( channel.pop( batch ) )
+      append( batch, events );
+    producer.join();
+    return events;
+  }
+
+  /**
+   * @brief The bytes the parse stage records when #readFromFile reads #path
+   */
+  std::uint64_t parsedBytes ( const std::string &path )
+  {
+    Qustodio::CommonStorageComponent component;
+    component.readFromFile( path );
+    for ( const Qustodio::ComposerPool::stage_statistics &stage: component.Pool().snapshot().stages )
+      if ( "parse" == stage.name )
+        return stage.bytes;
+    return 0;
+  }
+
+  /**
+   * @brief Checks that #readFromFile reports #path instead of reading it
+   */
+  void expectRejected ( const std::string &path, const std::string &what )
+  {
+    bool rejected = false;
+    try
+    {
+      readEvents( path );
+    }
+    catch ( const std::runtime_error & )
+    {
+      rejected = true;
+    }
+    Qustodio::Check::expect( rejected, "readFromFile rejects " + what );
+  }
+
+  /**
+   * @brief Checks that #actual holds the #expected events, reporting the first one that differs
+   */
+  void expectSame ( const std::vector< Event > &expected, const std::vector< Event > &actual, const std::string &what )
+  {
+    if ( !Qustodio::Check::expect( expected.size() == actual.size(), what + " reads " + std::to_string( actual.size() ) +
+                                   " events, not " + std::to_string( expected.size() ) ) )
+      return;
+    for ( std::size_t i = 0; i != expected.size(); ++i )
+      if ( !Qustodio::Check::expect( expected[i] == actual[i], what + " differs at event " + std::to_string( i ) ) )
+        return;
+  }
+} // namespace
+
+int main ( void )
+{
+  const std::string log = plainLog();
+  const std::string plainPath = temporaryFile();
+  const std::string gzipPath = temporaryFile();
+  const std::string membersPath = temporaryFile();
+  const std::string truncatedPath = temporaryFile();
+  const std::string zstdPath = temporaryFile();
+
+  writeFile( plainPath, log );
+  writeGzip( gzipPath, log, 1 );
+  writeGzip( membersPath, log, memberCount );
+
+  std::string gzip;
+  {
+    std::ifstream inp( gzipPath, std::ios::binary );
+    gzip.assign( std::istreambuf_iterator< char >( inp ), std::istreambuf_iterator< char >() );
+  }
+  writeFile( truncatedPath, gzip.substr( 0, gzip.size() / 2 ) );
+  writeFile( zstdPath, std::string( "\x28\xb5\x2f\xfd", 4 ) + std::string( 64, '\0' ) );
+
+  Qustodio::Check::expect( Qustodio::CompressedFile::Format::Gzip == Qustodio::CompressedFile::detect( gzipPath ),
+                           "detect finds gzip" );
+  Qustodio::Check::expect( Qustodio::CompressedFile::Format::Plain == Qustodio::CompressedFile::detect( plainPath ),
+                           "detect finds a plain log" );
+
+  const std::vector< Event > expected = readEvents( plainPath );
+  Qustodio::Check::expect( expected.size() > logEvents, "the plain log is read whole" );
+  Qustodio::Check::expect( !expected.empty() && "http://last.example.com/" == std::get< 0 >( expected.back() ),
+                           "the last record without its newline is read" );
+
+  expectSame( expected, readEvents( gzipPath ), "readFromFile of gzip" );
+  expectSame( expected, readEvents( membersPath ), "readFromFile of several gzip members" );
+  expectSame( expected, streamEvents( plainPath ), "streamFromFile of the plain log" );
+  expectSame( expected, streamEvents( gzipPath ), "streamFromFile of gzip" );
+
+  Qustodio::Check::expect( log.size() == parsedBytes( plainPath ), "the parse stage records the plain bytes" );
+  Qustodio::Check::expect( log.size() == parsedBytes( gzipPath ), "the parse stage records the decompressed bytes" );
+
+  expectRejected( truncatedPath, "a truncated gzip file" );
+  Qustodio::Check::expect( Qustodio::CompressedFile::Format::Zstd == Qustodio::CompressedFile::detect( zstdPath ),
+                           "detect finds zstd" );
+  Qustodio::Check::expect( !Qustodio::CompressedFile::supported( Qustodio::CompressedFile::Format::Zstd ),
+                           "zstd is not supported" );
+  expectRejected( zstdPath, "a zstd file" );
+
+  for ( const std::string &path: { plainPath, gzipPath, membersPath, truncatedPath, zstdPath } )
+    std::remove( path.c_str() );
+  return Qustodio::Check::report( "CompressedFileTest" );
+}
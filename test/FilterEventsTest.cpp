@@ -0,0 +1,147 @@
+/** @file
+ * @brief Filter Events Test
+ *
+ * This file contains the checks of the #FilterEvents scan of a segmented #EventVersion against the merged one
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref FilterEventsTest_legal_note_sec
+ *
+ * @section FilterEventsTest_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section FilterEventsTest_intro_sec Introduction
+ *
+ * Reads a synthetic log of the #LogGenerator several times, so the published version holds several segments, and
+ * runs the same filters over it and over the version CommonStorageComponent::Events republishes once it merges them.
+ * Checks that both give the same counts, aggregates and device results, and that the merged version has a newer
+ * number.
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I.. -I../benchmark ../[A-Z]*.cpp ../benchmark/LogGenerator.cpp FilterEventsTest.cpp -o FilterEventsTest
+ *
+ * @section FilterEventsTest_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section FilterEventsTest_install_sec Use
+ *
+ * @subsection FilterEventsTest_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#include "Check.hpp"
+#include "CommonStorageComponent.hpp"
+#include "FilterEvents.hpp"
+#include "LogGenerator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  const std::size_t logEvents = 100000; //< Records of the log, about three pieces of a read
+  const int reads = 3;                  //< Reads of the log, one segment each
+
+  /**
+   * @brief What a filter found, with the devices by name since every version numbers them on its own
+   */
+  struct Results
+  {
+    std::uint32_t count = 0;                                  //< FilterEvents::filteredResultsCount
+    std::uint64_t matches = 0;                                //< FilterAggregates::matches
+    std::vector< std::uint64_t > keywords;                    //< FilterAggregates::keywords
+    std::map< std::int64_t, std::uint64_t > hours;            //< FilterAggregates::hours
+    std::map< std::string, std::uint64_t > devices;           //< FilterAggregates::devices by device name
+    std::map< std::string, std::vector< std::uint64_t >> flagged; //< DeviceResult::matches by device name
+
+    bool operator== ( const Results &other ) const
+    {
+      return count == other.count && matches == other.matches && keywords == other.keywords && hours == other.hours &&
+             devices == other.devices && flagged == other.flagged;
+    }
+  };
+
+  /**
+   * @brief Runs every filter over the version published by #component
+   */
+  std::vector< Results > filter ( Qustodio::CommonStorageComponent &component )
+  {
+    std::vector< Results > results;
+    auto collect = [ &results ] ( Qustodio::FilterEvents &filterEvents )
+    {
+      Results result;
+      result.count = filterEvents.filteredResultsCount();
+      const Qustodio::FilterEvents::FilterAggregates &aggregates = filterEvents.aggregates();
+      result.matches = aggregates.matches;
+      result.keywords = aggregates.keywords;
+      result.hours = aggregates.hours;
+      for ( std::uint32_t id = 0; id < aggregates.devices.size(); ++id )
+        if ( aggregates.devices[id] > 0 )
+          result.devices[filterEvents.deviceName( id ).str()] = aggregates.devices[id];
+      results.push_back( result );
+    };
+
+    Qustodio::FilterEvents std( component, ".*(porn|xxx).*" );
+    collect( std );
+    Qustodio::FilterEvents dfa( component, "(p.rn|xxx)", Qustodio::FilterEvents::RegexEngine::Dfa );
+    collect( dfa );
+    Qustodio::FilterEvents keywords( component, Qustodio::LogGenerator::badWords() );
+    collect( keywords );
+
+    Qustodio::FilterEvents devices( component );
+    devices.filterDevices( ".*(porn|xxx).*" );
+    Results result;
+    for ( std::uint32_t id = 0; id < devices.deviceResults().size(); ++id )
+      if ( devices.deviceResults()[id].count > 0 )
+        result.flagged[devices.deviceName( id ).str()] = devices.deviceResults()[id].matches;
+    results.push_back( result );
+    return results;
+  }
+} // namespace
+
+int main ( void )
+{
+  char path[] = "/tmp/FilterEventsTestXXXXXX";
+  const int descriptor = ::mkstemp( path );
+  Qustodio::LogProfile profile;
+  profile.events = logEvents;
+  if ( descriptor < 0 || ( ::close( descriptor ), !Qustodio::LogGenerator( profile ).writeFile( path ) ) )
+  {
+    std::perror( "FilterEventsTest" );
+    return 2;
+  }
+
+  Qustodio::CommonStorageComponent component;
+  for ( int read = 0; read < reads; ++read )
+    component.readFromFile( path );
+  const std::shared_ptr< const Qustodio::EventVersion > segmented = component.Published();
+  Qustodio::Check::expect( segmented->segmentCount() > 1, "the reads publish several segments" );
+  const std::vector< Results > bySegment = filter( component );
+
+  const std::shared_ptr< const Qustodio::EventStore > merged = component.Events();
+  const std::shared_ptr< const Qustodio::EventVersion > republished = component.Published();
+  Qustodio::Check::expect( 1 == republished->segmentCount(), "Events republishes a single segment" );
+  Qustodio::Check::expect( republished->version() > segmented->version(), "Events republishes a newer version" );
+  Qustodio::Check::expect( merged->size() == segmented->size(), "Events merges every event" );
+  Qustodio::Check::expect( merged == component.Events(), "Events returns the merged store again" );
+  const std::vector< Results > byMerged = filter( component );
+
+  Qustodio::Check::expect( bySegment.size() == byMerged.size(), "every filter runs over both versions" );
+  for ( std::size_t f = 0; f != bySegment.size() && f != byMerged.size(); ++f )
+    Qustodio::Check::expect( bySegment[f] == byMerged[f], "filter " + std::to_string( f ) +
+                             " finds the same events over the segments and over the merged store" );
+  Qustodio::Check::expect( bySegment[0].count > 0 && !bySegment[3].flagged.empty(), "the filters flag events" );
+
+  std::remove( path );
+  return Qustodio::Check::report( "FilterEventsTest" );
+}
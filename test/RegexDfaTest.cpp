@@ -0,0 +1,216 @@
+/** @file
+ * @brief Regex DFA Test
+ *
+ * This file contains the checks of the #RegexDfa against std::regex_search
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref RegexDfaTest_legal_note_sec
+ *
+ * @section RegexDfaTest_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section RegexDfaTest_intro_sec Introduction
+ *
+ * Draws random patterns of the supported subset, from a fixed seed, and checks that RegexDfa::matches agrees with
+ * std::regex_search on random texts over a small alphabet, where the patterns match often. Also checks that the
+ * syntax outside the subset is rejected instead of being read differently than std::regex reads it.
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -I.. ../RegexDfa.cpp RegexDfaTest.cpp -o RegexDfaTest
+ *
+ * @section RegexDfaTest_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section RegexDfaTest_install_sec Use
+ *
+ * @subsection RegexDfaTest_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#include "Check.hpp"
+#include "RegexDfa.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const std::size_t patternCount = 20000; //< Random patterns compared
+  const std::size_t textCount = 20;       //< Random texts per pattern
+  const std::size_t maxTextLength = 12;   //< Longest random text
+
+  /**
+   * @brief Random patterns of the supported subset and random texts over #alphabet
+   */
+  class PatternGenerator
+  {
+    public:
+    explicit PatternGenerator ( std::uint32_t seed )
+            : random( seed )
+    { }
+
+    std::string pattern ()
+    {
+      std::string result = this->alternation( 0 );
+      // anchors are only supported around a single branch
+      const bool startAnchor = this->chance( 5 );
+      const bool endAnchor = this->chance( 5 );
+      if ( ( startAnchor || endAnchor ) && std::string::npos != result.find( '|' ) )
+        result = "(?:" + result + ")";
+      return ( startAnchor ? "^" : "" ) + result + ( endAnchor ? "$" : "" );
+    }
+
+    std::string text ()
+    {
+      std::string result( this->draw( maxTextLength + 1 ), ' ' );
+      for ( char &character: result )
+        character = alphabet[this->draw( sizeof( alphabet ) - 1 )];
+      return result;
+    }
+
+    private:
+    static constexpr char alphabet[] = "abc12.-_ /"; //< Characters of the texts
+
+    std::uint32_t draw ( std::uint32_t bound )
+    {
+      return std::uniform_int_distribution< std::uint32_t >( 0, bound - 1 )( this->random );
+    }
+
+    bool chance ( std::uint32_t oneIn )
+    {
+      return 0 == this->draw( oneIn );
+    }
+
+    std::string alternation ( unsigned depth )
+    {
+      std::string result = this->concatenation( depth );
+      while ( this->chance( 4 ) )
+        result += "|" + this->concatenation( depth );
+      return result;
+    }
+
+    std::string concatenation ( unsigned depth )
+    {
+      std::string result;
+      const std::uint32_t atoms = 1 + this->draw( 3 );
+      for ( std::uint32_t atom = 0; atom < atoms; ++atom )
+        result += this->quantified( depth );
+      return result;
+    }
+
+    std::string quantified ( unsigned depth )
+    {
+      static const char *const quantifiers[] = { "*", "+", "?", "*?", "+?", "{2}", "{1,3}", "{2,}", "{0,2}" };
+      std::string result = this->atom( depth );
+      if ( !this->chance( 3 ) )
+        return result;
+
+      // nested repetitions make std::regex backtrack exponentially, so a group repeated as a whole has none inside
+      const bool group = '(' == result[0];
+      if ( group && std::string::npos != result.find_first_of( "*+{", 1 ) )
+        return result;
+      if ( group && std::string::npos != result.find( '?', 3 ) )
+        return result;
+      return result + quantifiers[this->draw( sizeof( quantifiers ) / sizeof( quantifiers[0] ) )];
+    }
+
+    std::string atom ( unsigned depth )
+    {
+      static const char *const classes[] = { "[ab]", "[^a1]", "[a-c]", "[0-9.]", "[\\d_]", "[^\\w]", "[-a]", "[a\\-]" };
+      static const char *const escapes[] = { "\\d", "\\D", "\\w", "\\W", "\\s", "\\S", "\\.", "\\/", "\\-" };
+      switch ( this->draw( depth < 2 ? 6 : 4 ) )
+      {
+        case 0:
+          return std::string( 1, "abc12_ /"[this->draw( 8 )] );
+        case 1:
+          return ".";
+        case 2:
+          return classes[this->draw( sizeof( classes ) / sizeof( classes[0] ) )];
+        case 3:
+          return escapes[this->draw( sizeof( escapes ) / sizeof( escapes[0] ) )];
+        case 4:
+          return "(" + this->alternation( depth + 1 ) + ")";
+        default:
+          return "(?:" + this->alternation( depth + 1 ) + ")";
+      }
+    }
+
+    std::mt19937 random; //< The only source of randomness
+  };
+
+  constexpr char PatternGenerator::alphabet[];
+
+  /**
+   * @brief Checks that #pattern is rejected by the DFA
+   */
+  void expectRejected ( const std::string &pattern )
+  {
+    bool rejected = false;
+    try
+    {
+      Qustodio::RegexDfa dfa( pattern );
+    }
+    catch ( const std::invalid_argument & )
+    {
+      rejected = true;
+    }
+    Qustodio::Check::expect( rejected, "RegexDfa rejects " + pattern );
+  }
+} // namespace
+
+int main ( void )
+{
+  PatternGenerator generator( 2018 );
+  std::size_t compared = 0;
+  std::size_t tooLarge = 0;
+
+  for ( std::size_t p = 0; p < patternCount; ++p )
+  {
+    const std::string pattern = generator.pattern();
+    const std::regex reference( pattern, std::regex::ECMAScript );
+    std::unique_ptr< Qustodio::RegexDfa > dfa;
+    try
+    {
+      dfa.reset( new Qustodio::RegexDfa( pattern ) );
+    }
+    catch ( const std::invalid_argument &error )
+    {
+      // only the size limit may reject a pattern of the subset
+      ++tooLarge;
+      Qustodio::Check::expect( std::string( error.what() ).find( "states" ) != std::string::npos,
+                               "RegexDfa accepts " + pattern + ": " + error.what() );
+      continue;
+    }
+
+    for ( std::size_t t = 0; t < textCount; ++t )
+    {
+      const std::string text = generator.text();
+      Qustodio::Check::expect( std::regex_search( text, reference ) == dfa->matches( text ),
+                               "RegexDfa agrees with std::regex_search for " + pattern + " on \"" + text + "\"" );
+      ++compared;
+    }
+  }
+  std::printf( "%zu texts compared, %zu patterns over the state limit\n", compared, tooLarge );
+
+  // linear time where std::regex backtracks
+  const Qustodio::RegexDfa nested( "(a|aa)*b" );
+  Qustodio::Check::expect( !nested.matches( std::string( 4096, 'a' ) ), "(a|aa)*b does not match a run of a" );
+  Qustodio::Check::expect( nested.matches( std::string( 4096, 'a' ) + "b" ), "(a|aa)*b matches a run of a and b" );
+
+  // outside the subset, or read differently by std::regex than by the subset
+  for ( const char *pattern: { "[[:alpha:]]", "[[=a=]]", "[[.a.]]", "[\\d-x]", "[a-\\w]", "\\bword", "a(?=b)",
+                               "a(?!b)", "(a)\\1", "a|^b", "a^b", "**", "a{2,1}", "(a", "a)", "[a", "a\\" } )
+    expectRejected( pattern );
+
+  return Qustodio::Check::report( "RegexDfaTest" );
+}
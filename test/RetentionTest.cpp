@@ -0,0 +1,210 @@
+/** @file
+ * @brief Retention Test
+ *
+ * This file contains the checks of the segment eviction and recycling of the #CommonStorageComponent
+ * @author José Manuel Ramos Ruiz
+ * @date 16 Oct 2026 - Revisión 1.0
+ *
+ * @see @ref RetentionTest_legal_note_sec
+ *
+ * @section RetentionTest_legal_note_sec Legal Note
+ * Only for Qustodio hiring purposes
+ *
+ * @section RetentionTest_intro_sec Introduction
+ *
+ * Reads synthetic logs written by the #LogGenerator under a CommonStorageComponent::RetentionPolicy and checks that:
+ * - the published segments stay within RetentionPolicy::maxBytes and the newest events are kept
+ * - the segments older than RetentionPolicy::maxAgeSeconds are evicted
+ * - the evicted segments are recycled by the next reads, see CommonStorageComponent::RecycledShards
+ * - the segments of a version a reader holds are left untouched until it releases them
+ *
+ * Build it from this folder with:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I.. -I../benchmark ../[A-Z]*.cpp ../benchmark/LogGenerator.cpp RetentionTest.cpp -o RetentionTest
+ *
+ * @section RetentionTest_revision_sec Versions
+ * Versión | Fecha      | Autor                        | Comentarios adicionales
+ * ------: | :--------: | :--------------------------  | -----------------------
+ *     1.0 | 2026-10-16 | José Manuel Ramos Ruiz       | Initial Release
+ *
+ * @section RetentionTest_install_sec Use
+ *
+ * @subsection RetentionTest_step1 Requirements
+ * Requires C++11 to use it correctly
+ */
+
+#include "Check.hpp"
+#include "CommonStorageComponent.hpp"
+#include "LogGenerator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+  const std::size_t logEvents = 100000;     //< Records of every log, about 10 MB or three pieces of a read
+  const std::size_t maxBytes = 8 << 20;     //< Memory limit of the policy, below a whole log
+  const std::int64_t day = 24 * 60 * 60;    //< Seconds of a day
+
+  /**
+   * @brief Writes a log of #logEvents records starting at #firstTimestamp to a new temporary file
+   */
+  std::string writeLog ( std::int64_t firstTimestamp, std::uint32_t seed )
+  {
+    char path[] = "/tmp/RetentionTestXXXXXX";
+    const int descriptor = ::mkstemp( path );
+    if ( descriptor < 0 )
+    {
+      std::perror( "RetentionTest" );
+      std::exit( 2 );
+    }
+    ::close( descriptor );
+
+    Qustodio::LogProfile profile;
+    profile.events = logEvents;
+    profile.firstTimestamp = firstTimestamp;
+    profile.seed = seed;
+    Qustodio::LogGenerator generator( profile );
+    if ( !generator.writeFile( path ) )
+    {
+      std::perror( "RetentionTest" );
+      std::exit( 2 );
+    }
+    return path;
+  }
+
+  /**
+   * @brief FNV-1a of the urls and timestamps of every event of #version
+   */
+  std::uint64_t fingerprint ( const Qustodio::EventVersion &version )
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [ &hash ] ( std::uint64_t value )
+    {
+      hash ^= value;
+      hash *= 1099511628211ull;
+    };
+
+    for ( std::size_t s = 0; s != version.segmentCount(); ++s )
+    {
+      const Qustodio::EventStore &store = * version.segment( s );
+      for ( std::size_t i = 0; i < store.size(); ++i )
+      {
+        for ( char character: store.url( i ) )
+          mix( static_cast< unsigned char >( character ) );
+        mix( static_cast< std::uint64_t >( store.timestamp( i ) ) );
+      }
+    }
+    return hash;
+  }
+
+  /**
+   * @brief Memory of the segments of #version
+   */
+  std::size_t memoryUsage ( const Qustodio::EventVersion &version )
+  {
+    std::size_t bytes = 0;
+    for ( std::size_t s = 0; s != version.segmentCount(); ++s )
+      bytes += version.segment( s )->memoryUsage();
+    return bytes;
+  }
+
+  /**
+   * @brief The last event of the newest segment of #version
+   */
+  std::string lastUrl ( const Qustodio::EventVersion &version )
+  {
+    if ( 0 == version.segmentCount() )
+      return std::string();
+    const Qustodio::EventStore &store = * version.segment( version.segmentCount() - 1 );
+    return store.empty() ? std::string() : store.url( store.size() - 1 ).str();
+  }
+} // namespace
+
+int main ( void )
+{
+  const std::string oldLog = writeLog( 1545573000, 2018 );
+  const std::string newLog = writeLog( 1545573000 + 10 * day, 2019 );
+
+  Qustodio::CommonStorageComponent unlimited;
+  unlimited.readFromFile( newLog );
+  const std::string newestUrl = lastUrl( * unlimited.Published() );
+
+  // memory limit
+  {
+    Qustodio::CommonStorageComponent component;
+    Qustodio::CommonStorageComponent::RetentionPolicy policy;
+    policy.maxBytes = maxBytes;
+    component.setRetention( policy );
+
+    std::uint64_t version = 0;
+    for ( int read = 0; read < 5; ++read )
+    {
+      component.readFromFile( newLog );
+      const std::shared_ptr< const Qustodio::EventVersion > published = component.Published();
+      Qustodio::Check::expect( published->version() > version, "every read publishes a newer version" );
+      Qustodio::Check::expect( 1 == published->segmentCount() || memoryUsage( * published ) <= maxBytes,
+                               "the segments stay within maxBytes after read " + std::to_string( read ) );
+      Qustodio::Check::expect( published->size() < 2 * logEvents, "the older reads are evicted" );
+      Qustodio::Check::expect( newestUrl == lastUrl( * published ), "the newest event is kept" );
+      version = published->version();
+    }
+    Qustodio::Check::expect( component.RecycledShards() > 0, "the evicted segments are recycled" );
+
+    // a reader keeps its version whole while the reads go on
+    std::shared_ptr< const Qustodio::EventVersion > held = component.Published();
+    const std::uint64_t heldFingerprint = fingerprint( * held );
+    for ( int read = 0; read < 3; ++read )
+      component.readFromFile( newLog );
+    Qustodio::Check::expect( heldFingerprint == fingerprint( * held ), "a held version is not recycled" );
+
+    // and its segments are recycled once it lets them go
+    held.reset();
+    const std::uint64_t recycled = component.RecycledShards();
+    component.readFromFile( newLog );
+    component.readFromFile( newLog );
+    Qustodio::Check::expect( component.RecycledShards() > recycled, "a released version is recycled" );
+  }
+
+  // age limit, the logs carry their own time
+  {
+    Qustodio::CommonStorageComponent component;
+    Qustodio::CommonStorageComponent::RetentionPolicy policy;
+    policy.maxAgeSeconds = day;
+    component.setRetention( policy );
+    component.readFromFile( oldLog );
+    component.readFromFile( newLog );
+
+    const std::shared_ptr< const Qustodio::EventVersion > published = component.Published();
+    std::int64_t latest = Qustodio::EventStore::InvalidTimestamp;
+    for ( std::size_t s = 0; s != published->segmentCount(); ++s )
+      latest = std::max( latest, published->segment( s )->latestTimestamp() );
+    for ( std::size_t s = 0; s != published->segmentCount(); ++s )
+      Qustodio::Check::expect( published->segment( s )->latestTimestamp() >= latest - day,
+                               "segment " + std::to_string( s ) + " is younger than maxAgeSeconds" );
+    Qustodio::Check::expect( published->size() == unlimited.Published()->size(), "only the old log is evicted" );
+  }
+
+  // a policy set after the reads applies at once
+  {
+    Qustodio::CommonStorageComponent component;
+    for ( int read = 0; read < 3; ++read )
+      component.readFromFile( newLog );
+    Qustodio::CommonStorageComponent::RetentionPolicy policy;
+    policy.maxBytes = maxBytes;
+    component.setRetention( policy );
+    const std::shared_ptr< const Qustodio::EventVersion > published = component.Published();
+    Qustodio::Check::expect( published->size() < 3 * logEvents, "setRetention evicts at once" );
+    Qustodio::Check::expect( newestUrl == lastUrl( * published ), "setRetention keeps the newest event" );
+  }
+
+  std::remove( oldLog.c_str() );
+  std::remove( newLog.c_str() );
+  return Qustodio::Check::report( "RetentionTest" );
+}